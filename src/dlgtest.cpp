@@ -12,12 +12,14 @@
 #include "runtime/statedata.h"
 #include "runtime/states.h"
 #include "runtime/shared/qtgui/qfilewrap.h"
+#include "runtime/shared/qtgui/qrendertarget.h"
 #include "runtime/skills.h"
 #include "runtime/logger.h"
 
 CDlgTest::CDlgTest(QWidget *parent) :
     QDialog(parent),
     CGameMixin(),
+    m_target(new CRenderTarget()),
     ui(new Ui::CDlgTest)
 {
     ui->setupUi(this);
@@ -26,12 +28,14 @@ CDlgTest::CDlgTest(QWidget *parent) :
     m_timer.start();
     setSkill(SKILL_NORMAL);
     m_healthBar = HEALTHBAR_HEARTHS;
+    m_rewindEnabled = true;
     m_game->restartGame();
 }
 
 CDlgTest::~CDlgTest()
 {
     delete ui;
+    delete m_target;
 }
 
 void CDlgTest::init(CMapArch *mapfile,  const int level)
@@ -62,15 +66,17 @@ void CDlgTest::changeZoom()
 void CDlgTest::sanityTest()
 {
     CMap *map = m_maparch->at(m_game->level());
+    const levelMeta_t *cached = m_maparch->meta(*map);
+    const levelMeta_t meta = cached ? *cached : CGame::buildLevelMeta(*map);
     CStates & states = map->states();
     const uint16_t startPos = states.getU(POS_ORIGIN);
-    const Pos pos = startPos != 0 ? CMap::toPos(startPos) :  map->findFirst(TILES_ANNIE2);
+    const Pos pos = startPos != 0 ? CMap::toPos(startPos) : meta.origin;
     QStringList listIssues;
 
     if ((pos.x == CMap::NOT_FOUND ) && (pos.y == CMap::NOT_FOUND )) {
         listIssues.push_back(tr("No player on map"));
     }
-    if (map->count(TILES_DIAMOND) == 0) {
+    if (meta.diamonds == 0) {
         listIssues.push_back(tr("No diamond on map"));
     }
     if (listIssues.count() > 0) {
@@ -91,7 +97,10 @@ void CDlgTest::setZoom(bool zoom)
 
 void CDlgTest::paintEvent(QPaintEvent *)
 {
-    CFrame bitmap(getWidth(), getHeight());
+    // reuse the framebuffer; clear it since not every mode covers the screen
+    m_target->resize(getWidth(), getHeight(), m_zoom ? 2 : 1);
+    CFrame &bitmap = m_target->frame();
+    bitmap.fill(0);
     switch (m_game->mode())
     {
     case CGame::MODE_CHUTE:
@@ -119,10 +128,8 @@ void CDlgTest::paintEvent(QPaintEvent *)
     }
 
     // show the screen
-    const QImage & img = QImage(reinterpret_cast<uint8_t*>(bitmap.getRGB().data()), bitmap.width(), bitmap.height(), QImage::Format_RGBX8888);
-    const QPixmap & pixmap = QPixmap::fromImage(m_zoom ? img.scaled(QSize(getWidth() * 2, getHeight() * 2)): img);
     QPainter p(this);
-    p.drawPixmap(0, 0, pixmap);
+    m_target->draw(p);
     p.end();
 }
 
@@ -141,6 +148,9 @@ void CDlgTest::keyPressEvent(QKeyEvent *event)
     case Qt::Key_Right:
         m_joyState[AIM_RIGHT] = KEY_PRESSED;
         break;
+    case Qt::Key_Backspace:
+        rewind(REWIND_TICKS);
+        break;
     case Qt::Key_Escape:
         exitGame();
     }
@@ -6,6 +6,7 @@
 #include "runtime/gamemixin.h"
 
 class CMapFile;
+class CRenderTarget;
 
 namespace Ui
 {
@@ -28,6 +29,7 @@ protected slots:
 
 private:
     QTimer m_timer;
+    CRenderTarget *m_target;
     Ui::CDlgTest *ui;
     void keyPressEvent(QKeyEvent *event) override;
     void keyReleaseEvent(QKeyEvent *event) override;
@@ -0,0 +1,199 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <iterator>
+#include "botpolicy.h"
+#include "game.h"
+#include "tilesdata.h"
+#include "tilesdefs.h"
+#include "sprtypes.h"
+#include "states.h"
+#include "statedata.h"
+
+namespace BotPolicyPrivate
+{
+    constexpr JoyAim AIMS[] = {AIM_UP, AIM_DOWN, AIM_LEFT, AIM_RIGHT};
+    constexpr uint32_t RANDOM_TURN_ODDS = 8;
+};
+
+using namespace BotPolicyPrivate;
+
+std::unique_ptr<IBotPolicy> IBotPolicy::create(const std::string &name)
+{
+    if (name == "greedy")
+        return std::make_unique<CGreedyBot>();
+    if (name == "random")
+        return std::make_unique<CRandomBot>();
+    return nullptr;
+}
+
+const char *IBotPolicy::names()
+{
+    return "greedy, random";
+}
+
+void CRandomBot::reset(const uint32_t seed)
+{
+    m_rng = Random(seed);
+    m_aim = AIM_NONE;
+}
+
+JoyAim CRandomBot::decide(const CGame &game)
+{
+    if (m_aim == AIM_NONE ||
+        !game.playerConst().canMove(game, m_aim) ||
+        m_rng.next() % RANDOM_TURN_ODDS == 0)
+        m_aim = AIMS[m_rng.next() % std::size(AIMS)];
+    return m_aim;
+}
+
+void CGreedyBot::reset(const uint32_t seed)
+{
+    m_rng = Random(seed);
+    m_lastPos = Pos{CMap::NOT_FOUND, CMap::NOT_FOUND};
+    m_aim = AIM_NONE;
+    m_randomTicks = 0;
+}
+
+JoyAim CGreedyBot::decide(const CGame &game)
+{
+    const CActor &player = game.playerConst();
+    const Pos pos = player.pos();
+    if (m_randomTicks)
+    {
+        --m_randomTicks;
+        return m_aim;
+    }
+    if (pos == m_lastPos && m_aim != AIM_NONE && player.canMove(game, m_aim))
+        return m_aim;
+
+    m_lastPos = pos;
+    if (m_rng.next() % RANDOM_MOVE_ODDS == 0)
+    {
+        m_aim = AIMS[m_rng.next() % std::size(AIMS)];
+        m_randomTicks = RANDOM_MOVE_TICKS;
+        return m_aim;
+    }
+    m_aim = findPath(game, TARGET_DIAMOND, false);
+    if (m_aim == AIM_NONE)
+        m_aim = findPath(game, TARGET_DIAMOND, true);
+    return m_aim;
+}
+
+/**
+ * @brief Breadth-first search from the player to the best target in reach
+ *
+ * @param game
+ * @param want best target to look for
+ * @param hazards allow walking through swamps and fire
+ * @return JoyAim first step, AIM_NONE if nothing is reachable
+ */
+JoyAim CGreedyBot::findPath(const CGame &game, const Target want, const bool hazards)
+{
+    const CMap &map = game.map();
+    const int len = map.len();
+    const Pos start = game.playerConst().pos();
+    m_parent.assign(len * map.hei(), -1);
+    m_queue.clear();
+
+    const int32_t startIndex = start.x + start.y * len;
+    m_parent[startIndex] = startIndex;
+    m_queue.push_back(startIndex);
+    int32_t best = -1;
+    Target bestTarget = TARGET_NONE;
+    for (size_t head = 0; head < m_queue.size(); ++head)
+    {
+        const int32_t index = m_queue[head];
+        const Pos pos{static_cast<int16_t>(index % len), static_cast<int16_t>(index / len)};
+        if (index != startIndex)
+        {
+            // nearest of each kind wins; keep looking for a better kind
+            const Target target = targetOf(game, pos, map.at(pos.x, pos.y));
+            if (target > bestTarget)
+            {
+                best = index;
+                bestTarget = target;
+                if (target >= want)
+                    break;
+            }
+        }
+        for (const JoyAim aim : AIMS)
+        {
+            const Pos next = game.translate(pos, aim);
+            const int32_t nextIndex = next.x + next.y * len;
+            if (m_parent[nextIndex] != -1 || !isWalkable(game, map.at(next.x, next.y), hazards))
+                continue;
+            m_parent[nextIndex] = index;
+            m_queue.push_back(nextIndex);
+        }
+    }
+    if (best == -1)
+        return AIM_NONE;
+
+    // walk back to the first step
+    int32_t step = best;
+    while (m_parent[step] != startIndex)
+        step = m_parent[step];
+    const int dx = step % len - start.x;
+    const int dy = step / len - start.y;
+    if (dy < 0)
+        return AIM_UP;
+    if (dy > 0)
+        return AIM_DOWN;
+    return dx < 0 ? AIM_LEFT : AIM_RIGHT;
+}
+
+CGreedyBot::Target CGreedyBot::targetOf(const CGame &game, const Pos &pos, const uint8_t tile)
+{
+    if (game.goalCount() == 0)
+    {
+        const uint16_t exitKey = game.map().statesConst().getU(POS_EXIT);
+        return exitKey != 0 && pos == CMap::toPos(exitKey) ? TARGET_EXIT : TARGET_NONE;
+    }
+    switch (getTileDef(tile).type)
+    {
+    case TYPE_DIAMOND:
+        return TARGET_DIAMOND;
+    case TYPE_KEY:
+        return TARGET_KEY;
+    case TYPE_PICKUP:
+        return TARGET_PICKUP;
+    default:
+        return TARGET_NONE;
+    }
+}
+
+bool CGreedyBot::isWalkable(const CGame &game, const uint8_t tile, const bool hazards)
+{
+    const TileDef &def = getTileDef(tile);
+    switch (def.type)
+    {
+    case TYPE_BACKGROUND:
+    case TYPE_STOP:
+    case TYPE_PICKUP:
+    case TYPE_DIAMOND:
+    case TYPE_KEY:
+        return true;
+    case TYPE_DOOR:
+        return game.hasKey(tile + 1);
+    case TYPE_SWAMP:
+    case TYPE_FIRE:
+        return hazards;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,101 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "map.h"
+#include "randomz.h"
+#include "joyaim.h"
+
+class CGame;
+
+/**
+ * @brief Automated player used by the batch playtests.
+ *        One instance per worker; it may keep state between ticks.
+ */
+class IBotPolicy
+{
+public:
+    virtual ~IBotPolicy() = default;
+    virtual const char *name() const = 0;
+    // called at the start of each episode
+    virtual void reset(const uint32_t seed) = 0;
+    // direction to hold for this tick; AIM_NONE to stand still
+    virtual JoyAim decide(const CGame &game) = 0;
+
+    static std::unique_ptr<IBotPolicy> create(const std::string &name);
+    static const char *names();
+};
+
+/**
+ * @brief Walks in a random direction, changing it from time to time.
+ */
+class CRandomBot : public IBotPolicy
+{
+public:
+    const char *name() const override { return "random"; }
+    void reset(const uint32_t seed) override;
+    JoyAim decide(const CGame &game) override;
+
+private:
+    Random m_rng;
+    JoyAim m_aim = AIM_NONE;
+};
+
+/**
+ * @brief Heads for the nearest diamond (BFS over the tiles the player can
+ *        enter), then for the exit. Falls back on keys and pickups when no
+ *        diamond is reachable. A few seeded random moves per episode make
+ *        the episodes differ.
+ */
+class CGreedyBot : public IBotPolicy
+{
+public:
+    const char *name() const override { return "greedy"; }
+    void reset(const uint32_t seed) override;
+    JoyAim decide(const CGame &game) override;
+
+private:
+    enum : uint32_t
+    {
+        RANDOM_MOVE_ODDS = 16, // 1 in N decisions
+        RANDOM_MOVE_TICKS = 6,
+    };
+
+    enum Target : uint8_t
+    {
+        TARGET_NONE,
+        TARGET_PICKUP,
+        TARGET_KEY,
+        TARGET_DIAMOND,
+        TARGET_EXIT,
+    };
+
+    Random m_rng;
+    Pos m_lastPos{CMap::NOT_FOUND, CMap::NOT_FOUND};
+    JoyAim m_aim = AIM_NONE;
+    uint32_t m_randomTicks = 0;
+    std::vector<int32_t> m_parent;
+    std::vector<int32_t> m_queue;
+    JoyAim findPath(const CGame &game, const Target want, const bool hazards);
+    static Target targetOf(const CGame &game, const Pos &pos, const uint8_t tile);
+    static bool isWalkable(const CGame &game, const uint8_t tile, const bool hazards);
+};
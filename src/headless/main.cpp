@@ -0,0 +1,388 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Headless replay of a recorded session, batch playtests with a bot,
+// static level checks or archive reports: no Qt, no SDL, no pacing.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "game.h"
+#include "maparch.h"
+#include "recorder.h"
+#include "simrunner.h"
+#include "playtest.h"
+#include "botpolicy.h"
+#include "analyzer.h"
+#include "archreport.h"
+#include "logger.h"
+#include "shared/FileWrap.h"
+
+namespace HeadlessPrivate
+{
+    constexpr uint32_t DEFAULT_MAX_TICKS = 24 * 60 * 60; // 1h of play
+    constexpr uint32_t CLOSURE_GRACE_TICKS = 24 * 10;
+};
+
+using namespace HeadlessPrivate;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-v] [-t maxTicks] <archive.mapz> <recording.rec>\n", prog);
+    fprintf(stderr, "       %s -b [-v] [-t maxTicks] [-e episodes] [-j jobs] [-p policy] [-s seed]\n"
+                    "          [-k skill] [-l level[:last]] [-o report.csv|report.json] <archive.mapz>\n",
+            prog);
+    fprintf(stderr, "       %s -a [-j jobs] <archive.mapz>\n", prog);
+    fprintf(stderr, "       %s -r [-j jobs] <archive.mapz> <report.txt|report.json>\n", prog);
+    fprintf(stderr, "policies: %s\n", IBotPolicy::names());
+}
+
+static bool endsWith(const std::string &str, const char *suffix)
+{
+    const size_t len = strlen(suffix);
+    return str.size() >= len && str.compare(str.size() - len, len, suffix) == 0;
+}
+
+/**
+ * @brief Play seeded episodes of each level with a bot and write a report
+ *
+ * @param argc
+ * @param argv
+ * @return int exit code
+ */
+static int batch(int argc, char *argv[])
+{
+    CPlaytest::config_t config;
+    const char *archFile = nullptr;
+    std::string reportFile;
+    bool verbose = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-v") == 0)
+            verbose = true;
+        else if (strcmp(argv[i], "-t") == 0 && hasValue)
+            config.maxTicks = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "-e") == 0 && hasValue)
+            config.episodes = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "-j") == 0 && hasValue)
+            config.jobs = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "-p") == 0 && hasValue)
+            config.policy = argv[++i];
+        else if (strcmp(argv[i], "-s") == 0 && hasValue)
+            config.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "-k") == 0 && hasValue)
+            config.skill = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-l") == 0 && hasValue)
+        {
+            // 1-based, like the level numbers shown in game
+            char *end = nullptr;
+            config.firstLevel = static_cast<int>(strtol(argv[++i], &end, 10)) - 1;
+            config.lastLevel = *end == ':' ? static_cast<int>(strtol(end + 1, nullptr, 10)) - 1 : config.firstLevel;
+        }
+        else if (strcmp(argv[i], "-o") == 0 && hasValue)
+            reportFile = argv[++i];
+        else if (!archFile)
+            archFile = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!archFile || config.episodes == 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    Logger::setLevel(verbose ? Logger::L_INFO : Logger::L_ERROR);
+
+    CMapArch arch;
+    if (!arch.read(archFile))
+    {
+        fprintf(stderr, "can't read %s: %s\n", archFile, arch.lastError());
+        return EXIT_FAILURE;
+    }
+
+    CPlaytest playtest(arch, config);
+    const auto start = std::chrono::steady_clock::now();
+    if (!playtest.run())
+    {
+        fprintf(stderr, "playtest failed: %s\n", playtest.lastError());
+        return EXIT_FAILURE;
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    uint32_t episodes = 0;
+    for (const auto &report : playtest.reports())
+    {
+        episodes += report.episodes;
+        printf("level %d: %u/%u cleared", report.level + 1, report.cleared, report.episodes);
+        for (int i = 0; i < CPlaytest::CAUSE_COUNT; ++i)
+        {
+            if (report.deaths[i])
+                printf(", %s: %u", CPlaytest::causeName(i), report.deaths[i]);
+        }
+        if (report.unfinished)
+            printf(", unfinished: %u", report.unfinished);
+        printf("\n");
+    }
+    const double secs = std::chrono::duration<double>(end - start).count();
+    printf("episodes: %u in %.1fs\n", episodes, secs);
+
+    if (!reportFile.empty())
+    {
+        const bool ok = endsWith(reportFile, ".json")
+                            ? playtest.writeJSON(reportFile)
+                            : playtest.writeCSV(reportFile);
+        if (!ok)
+        {
+            fprintf(stderr, "can't write %s\n", reportFile.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Static check of every level: solvability, unreachable diamonds,
+ *        unused keys and softlocks
+ *
+ * @param argc
+ * @param argv
+ * @return int exit code, failure if a level can't be won
+ */
+static int analyze(int argc, char *argv[])
+{
+    const char *archFile = nullptr;
+    unsigned jobs = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            jobs = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        else if (!archFile)
+            archFile = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!archFile)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    Logger::setLevel(Logger::L_ERROR);
+
+    CMapArch arch;
+    if (!arch.read(archFile))
+    {
+        fprintf(stderr, "can't read %s: %s\n", archFile, arch.lastError());
+        return EXIT_FAILURE;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<levelAnalysis_t> results = CLevelAnalyzer::runAll(arch, jobs);
+    const auto end = std::chrono::steady_clock::now();
+    bool solvable = true;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const levelAnalysis_t &result = results[i];
+        solvable &= result.solvable;
+        printf("level %zu: %s, %u states%s%s\n", i + 1,
+               result.solvable ? "solvable" : "NOT SOLVABLE", result.states,
+               result.chute ? ", chute" : "", result.truncated ? ", partial" : "");
+        for (const Pos &pos : result.unreachableDiamonds)
+            printf("  unreachable diamond at %d,%d\n", pos.x, pos.y);
+        for (const Pos &pos : result.unusedKeys)
+            printf("  unused key at %d,%d\n", pos.x, pos.y);
+        for (const softlock_t &softlock : result.softlocks)
+            printf("  softlock: pushing %d,%d %s\n", softlock.block.x, softlock.block.y,
+                   softlock.aim == AIM_UP ? "up" : softlock.aim == AIM_DOWN ? "down" : softlock.aim == AIM_LEFT ? "left" : "right");
+    }
+    printf("levels: %zu in %.3fs\n", results.size(), std::chrono::duration<double>(end - start).count());
+    return solvable ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Write the archive statistics as text or JSON
+ *
+ * @param argc
+ * @param argv
+ * @return int exit code
+ */
+static int report(int argc, char *argv[])
+{
+    const char *archFile = nullptr;
+    const char *reportFile = nullptr;
+    unsigned jobs = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            jobs = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        else if (!archFile)
+            archFile = argv[i];
+        else if (!reportFile)
+            reportFile = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!archFile || !reportFile)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    Logger::setLevel(Logger::L_ERROR);
+
+    CMapArch arch;
+    if (!arch.read(archFile))
+    {
+        fprintf(stderr, "can't read %s: %s\n", archFile, arch.lastError());
+        return EXIT_FAILURE;
+    }
+    CArchReport archReport;
+    archReport.build(arch, jobs);
+    CFileWrap file;
+    if (!file.open(reportFile, "wb") || !archReport.write(file, endsWith(reportFile, ".json")))
+    {
+        fprintf(stderr, "can't write %s\n", reportFile);
+        return EXIT_FAILURE;
+    }
+    file.close();
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "-b") == 0)
+        return batch(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "-a") == 0)
+        return analyze(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "-r") == 0)
+        return report(argc, argv);
+
+    const char *archFile = nullptr;
+    const char *recFile = nullptr;
+    uint32_t maxTicks = DEFAULT_MAX_TICKS;
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+            verbose = true;
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            maxTicks = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (!archFile)
+            archFile = argv[i];
+        else if (!recFile)
+            recFile = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (!archFile || !recFile)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    Logger::setLevel(verbose ? Logger::L_INFO : Logger::L_ERROR);
+
+    CMapArch arch;
+    if (!arch.read(archFile))
+    {
+        fprintf(stderr, "can't read %s: %s\n", archFile, arch.lastError());
+        return EXIT_FAILURE;
+    }
+
+    CGame game;
+    game.setMapArch(&arch);
+    CSimRunner runner(game);
+    CFileWrap file;
+    if (!file.open(recFile, "rb"))
+    {
+        fprintf(stderr, "can't read %s\n", recFile);
+        return EXIT_FAILURE;
+    }
+    std::string name;
+    if (!runner.read(file, name))
+    {
+        fprintf(stderr, "invalid savegame in %s\n", recFile);
+        return EXIT_FAILURE;
+    }
+    CRecorder recorder;
+    if (!recorder.start(&file, false))
+    {
+        fprintf(stderr, "invalid recording in %s\n", recFile);
+        return EXIT_FAILURE;
+    }
+
+    const uint32_t startTick = runner.ticks();
+    uint8_t joyState[CSimRunner::JOY_AIMS] = {0, 0, 0, 0};
+    uint32_t grace = CLOSURE_GRACE_TICKS;
+    const auto start = std::chrono::steady_clock::now();
+    while (runner.outcome() == CSimRunner::Running &&
+           runner.ticks() - startTick < maxTicks)
+    {
+        if (recorder.isReading())
+        {
+            const bool hasInput = recorder.get(joyState);
+            if (recorder.hasCheckpoint())
+                recorder.verify(game.stateHash());
+            if (!hasInput)
+            {
+                recorder.stop();
+                memset(joyState, 0, sizeof(joyState));
+            }
+        }
+        if (recorder.isStopped())
+        {
+            // inputs exhausted: only let a pending closure play out
+            if (!game.isClosure() || grace-- == 0)
+                break;
+        }
+        runner.step(joyState);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    recorder.stop();
+
+    const uint32_t ticks = runner.ticks() - startTick;
+    const double secs = std::chrono::duration<double>(end - start).count();
+    const double rate = secs > 0 ? ticks / secs : 0.0;
+    const char *outcome = runner.outcome() == CSimRunner::Running
+                              ? "incomplete"
+                              : CSimRunner::outcomeName(runner.outcome());
+    printf("save: %s\n", name.c_str());
+    printf("ticks: %u\n", ticks);
+    printf("ticks/s: %.0f\n", rate);
+    printf("level: %d\n", game.level() + 1);
+    printf("score: %d\n", game.score());
+    printf("lives: %d\n", game.lives());
+    printf("outcome: %s\n", outcome);
+    if (recorder.diverged())
+        printf("desync: tick %u (%s)\n", recorder.divergedTick(),
+               stateHash_t::partName(recorder.divergedPart()));
+    else
+        printf("desync: none (%u checkpoints)\n", recorder.checkpoints());
+    return recorder.diverged() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
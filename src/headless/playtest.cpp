@@ -0,0 +1,345 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include "playtest.h"
+#include "botpolicy.h"
+#include "game.h"
+#include "maparch.h"
+#include "simrunner.h"
+#include "boss.h"
+#include "events.h"
+#include "tilesdata.h"
+#include "tilesdefs.h"
+#include "sprtypes.h"
+#include "statehash.h"
+#include "logger.h"
+#include "shared/FileWrap.h"
+
+namespace PlaytestPrivate
+{
+    // a death never ends the session, so every death reads as Died
+    constexpr int EPISODE_LIVES = 2;
+    constexpr size_t LINE_SIZE = 512;
+};
+
+using namespace PlaytestPrivate;
+
+CPlaytest::CPlaytest(CMapArch &arch, const config_t &config) : m_arch(arch), m_config(config)
+{
+}
+
+void CPlaytest::levelReport_t::merge(const levelReport_t &other)
+{
+    episodes += other.episodes;
+    cleared += other.cleared;
+    unfinished += other.unfinished;
+    for (int i = 0; i < CAUSE_COUNT; ++i)
+        deaths[i] += other.deaths[i];
+    clearTicks += other.clearTicks;
+    clearTimes.insert(clearTimes.end(), other.clearTimes.begin(), other.clearTimes.end());
+    if (healthSum.size() < other.healthSum.size())
+    {
+        healthSum.resize(other.healthSum.size());
+        healthCount.resize(other.healthCount.size());
+    }
+    for (size_t i = 0; i < other.healthSum.size(); ++i)
+    {
+        healthSum[i] += other.healthSum[i];
+        healthCount[i] += other.healthCount[i];
+    }
+}
+
+/**
+ * @brief Play every episode of every selected level
+ *
+ * @return true
+ * @return false if the configuration is invalid
+ */
+bool CPlaytest::run()
+{
+    const int count = static_cast<int>(m_arch.size());
+    const int first = m_config.firstLevel;
+    const int last = m_config.lastLevel < 0 ? count - 1 : m_config.lastLevel;
+    if (first < 0 || first > last || last >= count)
+    {
+        m_lastError = "invalid level range";
+        return false;
+    }
+    if (!IBotPolicy::create(m_config.policy))
+    {
+        m_lastError = "unknown policy: " + m_config.policy + " (" + IBotPolicy::names() + ")";
+        return false;
+    }
+
+    const uint32_t levels = last - first + 1;
+    const uint32_t total = levels * m_config.episodes;
+    unsigned jobs = m_config.jobs ? m_config.jobs : std::thread::hardware_concurrency();
+    jobs = std::max(1u, std::min(jobs, total));
+
+    // scan the levels here: the workers only read the shared archive
+    for (int i = first; i <= last; ++i)
+    {
+        CMap &map = *m_arch.at(i);
+        if (!m_arch.meta(map))
+            m_arch.setMeta(map, CGame::buildLevelMeta(map));
+    }
+
+    // per worker tallies, merged once everyone is done
+    std::vector<std::vector<levelReport_t>> tallies(jobs, std::vector<levelReport_t>(levels));
+    std::atomic<uint32_t> next{0};
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < jobs; ++i)
+        workers.emplace_back(&CPlaytest::worker, this, std::ref(tallies[i]), std::ref(next), total);
+    worker(tallies[0], next, total);
+    for (auto &thread : workers)
+        thread.join();
+
+    m_reports.assign(levels, levelReport_t{});
+    for (uint32_t i = 0; i < levels; ++i)
+    {
+        m_reports[i].level = first + i;
+        for (const auto &tally : tallies)
+            m_reports[i].merge(tally[i]);
+        std::sort(m_reports[i].clearTimes.begin(), m_reports[i].clearTimes.end());
+    }
+    return true;
+}
+
+void CPlaytest::worker(std::vector<levelReport_t> &reports, std::atomic<uint32_t> &next, const uint32_t total) const
+{
+    CGame game;
+    game.setMapArch(&m_arch);
+    std::unique_ptr<IBotPolicy> bot = IBotPolicy::create(m_config.policy);
+    for (uint32_t job = next++; job < total; job = next++)
+    {
+        const uint32_t index = job / m_config.episodes;
+        const uint32_t episode = job % m_config.episodes;
+        const int level = m_config.firstLevel + index;
+        // the seed only depends on the episode, not on who plays it
+        const uint32_t seed = static_cast<uint32_t>(StateHash::mix(
+            (static_cast<uint64_t>(m_config.seed) << 32) | (static_cast<uint64_t>(level) << 20) | episode));
+        playEpisode(game, *bot, level, seed, reports[index]);
+    }
+}
+
+void CPlaytest::playEpisode(CGame &game, IBotPolicy &bot, const int level, const uint32_t seed, levelReport_t &report) const
+{
+    game.setSkill(m_config.skill);
+    game.setLives(EPISODE_LIVES);
+    game.setLevel(level);
+    game.rng() = Random(seed);
+    game.loadLevel(CGame::MODE_LEVEL_INTRO);
+    game.setMode(CGame::MODE_PLAY);
+    bot.reset(seed);
+
+    CSimRunner runner(game);
+    uint8_t joyState[CSimRunner::JOY_AIMS];
+    int lastHealth = game.health();
+    uint8_t cause = CAUSE_OTHER;
+    while (runner.outcome() == CSimRunner::Running && runner.ticks() < m_config.maxTicks)
+    {
+        if (runner.ticks() % CSimRunner::TICK_RATE == 0)
+        {
+            const size_t second = runner.ticks() / CSimRunner::TICK_RATE;
+            if (report.healthSum.size() <= second)
+            {
+                report.healthSum.resize(second + 1);
+                report.healthCount.resize(second + 1);
+            }
+            report.healthSum[second] += game.health();
+            ++report.healthCount[second];
+        }
+
+        memset(joyState, 0, sizeof(joyState));
+        const JoyAim aim = bot.decide(game);
+        if (aim != AIM_NONE)
+            joyState[aim] = 1;
+        runner.step(joyState);
+
+        bool trapped = false;
+        for (int event = game.getEvent(); event != EVENT_NONE; event = game.getEvent())
+            trapped |= event == EVENT_TRAP;
+        if (game.health() < lastHealth)
+            cause = classifyHurt(game, trapped);
+        lastHealth = game.health();
+    }
+
+    ++report.episodes;
+    switch (runner.outcome())
+    {
+    case CSimRunner::Completed:
+    case CSimRunner::Chute:
+        ++report.cleared;
+        report.clearTicks += runner.ticks();
+        report.clearTimes.emplace_back(runner.ticks());
+        break;
+    case CSimRunner::TimedOut:
+        ++report.deaths[CAUSE_TIMEOUT];
+        break;
+    case CSimRunner::Died:
+    case CSimRunner::GameOver:
+        ++report.deaths[cause];
+        break;
+    case CSimRunner::Running:
+        ++report.unfinished;
+        break;
+    }
+}
+
+/**
+ * @brief Best guess at what just hurt the player, from its surroundings.
+ *        The game doesn't track damage sources.
+ *
+ * @param game
+ * @param trapped a trap was triggered this tick
+ * @return uint8_t CAUSE_xxx
+ */
+uint8_t CPlaytest::classifyHurt(CGame &game, const bool trapped)
+{
+    if (trapped)
+        return CAUSE_TRAP;
+
+    const CActor &player = game.playerConst();
+    const uint8_t pu = player.getPU();
+    const uint8_t puType = getTileDef(pu).type;
+    if (puType == TYPE_SWAMP || puType == TYPE_FIRE || pu == TILES_FLAME)
+        return CAUSE_TERRAIN;
+
+    const Pos pos = player.pos();
+    for (const CBoss &boss : game.bosses())
+    {
+        if (boss.isHidden() || boss.state() == CBoss::BossState::Death)
+            continue;
+        const Pos bossPos = boss.worldPos();
+        const hitbox_t &hitbox = boss.hitbox();
+        const int granular = CBoss::BOSS_GRANULAR_FACTOR;
+        if (pos.x >= bossPos.x - 1 && pos.x <= bossPos.x + (hitbox.x + hitbox.width) / granular + 1 &&
+            pos.y >= bossPos.y - 1 && pos.y <= bossPos.y + (hitbox.y + hitbox.height) / granular + 1)
+            return CAUSE_BOSS;
+    }
+
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            if (game.findMonsterAt(pos.x + dx, pos.y + dy) != CGame::INVALID)
+                return CAUSE_MONSTER;
+        }
+    }
+    return CAUSE_OTHER;
+}
+
+uint32_t CPlaytest::median(std::vector<uint32_t> values)
+{
+    if (values.empty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+const char *CPlaytest::causeName(const int cause)
+{
+    constexpr const char *names[] = {"monster", "boss", "terrain", "trap", "timeout", "other"};
+    return cause >= 0 && cause < CAUSE_COUNT ? names[cause] : "unknown";
+}
+
+/**
+ * @brief One line per level
+ *
+ * @param path
+ * @return true
+ * @return false
+ */
+bool CPlaytest::writeCSV(const std::string &path) const
+{
+    CFileWrap file;
+    if (!file.open(path.c_str(), "wb"))
+        return false;
+    char tmp[LINE_SIZE];
+    file += "level,episodes,cleared,clear_rate,unfinished,mean_clear_ticks,median_clear_ticks";
+    for (int i = 0; i < CAUSE_COUNT; ++i)
+    {
+        snprintf(tmp, sizeof(tmp), ",deaths_%s", causeName(i));
+        file += tmp;
+    }
+    file += "\n";
+    for (const auto &report : m_reports)
+    {
+        const double rate = report.episodes ? static_cast<double>(report.cleared) / report.episodes : 0.0;
+        const double meanTicks = report.cleared ? static_cast<double>(report.clearTicks) / report.cleared : 0.0;
+        snprintf(tmp, sizeof(tmp), "%d,%u,%u,%.4f,%u,%.1f,%u",
+                 report.level + 1, report.episodes, report.cleared, rate,
+                 report.unfinished, meanTicks, median(report.clearTimes));
+        file += tmp;
+        for (int i = 0; i < CAUSE_COUNT; ++i)
+        {
+            snprintf(tmp, sizeof(tmp), ",%u", report.deaths[i]);
+            file += tmp;
+        }
+        file += "\n";
+    }
+    file.close();
+    return true;
+}
+
+/**
+ * @brief Full report, including the health curves
+ *
+ * @param path
+ * @return true
+ * @return false
+ */
+bool CPlaytest::writeJSON(const std::string &path) const
+{
+    CFileWrap file;
+    if (!file.open(path.c_str(), "wb"))
+        return false;
+    char tmp[LINE_SIZE];
+    snprintf(tmp, sizeof(tmp), "{\n  \"policy\": \"%s\",\n  \"seed\": %u,\n  \"skill\": %d,\n  \"maxTicks\": %u,\n  \"tickRate\": %u,\n  \"levels\": [",
+             m_config.policy.c_str(), m_config.seed, m_config.skill, m_config.maxTicks, static_cast<uint32_t>(CSimRunner::TICK_RATE));
+    file += tmp;
+    for (size_t n = 0; n < m_reports.size(); ++n)
+    {
+        const auto &report = m_reports[n];
+        const double rate = report.episodes ? static_cast<double>(report.cleared) / report.episodes : 0.0;
+        const double meanTicks = report.cleared ? static_cast<double>(report.clearTicks) / report.cleared : 0.0;
+        snprintf(tmp, sizeof(tmp), "%s\n    {\n      \"level\": %d,\n      \"episodes\": %u,\n      \"cleared\": %u,\n      \"clearRate\": %.4f,\n      \"unfinished\": %u,\n      \"meanClearTicks\": %.1f,\n      \"medianClearTicks\": %u,\n      \"deaths\": {",
+                 n ? "," : "", report.level + 1, report.episodes, report.cleared, rate,
+                 report.unfinished, meanTicks, median(report.clearTimes));
+        file += tmp;
+        for (int i = 0; i < CAUSE_COUNT; ++i)
+        {
+            snprintf(tmp, sizeof(tmp), "%s\"%s\": %u", i ? ", " : "", causeName(i), report.deaths[i]);
+            file += tmp;
+        }
+        file += "},\n      \"healthCurve\": [";
+        for (size_t i = 0; i < report.healthSum.size(); ++i)
+        {
+            const double mean = report.healthCount[i] ? static_cast<double>(report.healthSum[i]) / report.healthCount[i] : 0.0;
+            snprintf(tmp, sizeof(tmp), "%s%.1f", i ? ", " : "", mean);
+            file += tmp;
+        }
+        file += "]\n    }";
+    }
+    file += "\n  ]\n}\n";
+    file.close();
+    return true;
+}
@@ -0,0 +1,98 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CMapArch;
+class CGame;
+class IBotPolicy;
+
+/**
+ * @brief Plays seeded episodes of each level with a bot, on all cores.
+ *
+ * An episode is one attempt at a level: it ends when the level is cleared,
+ * the player dies, the level timer runs out or maxTicks is reached. Each
+ * worker owns its game session, bot and tallies; the archive is shared
+ * read-only. Tallies are integer sums merged after the run, so the report
+ * doesn't depend on the number of workers.
+ */
+class CPlaytest
+{
+public:
+    enum Cause : uint8_t
+    {
+        CAUSE_MONSTER,
+        CAUSE_BOSS,
+        CAUSE_TERRAIN,
+        CAUSE_TRAP,
+        CAUSE_TIMEOUT,
+        CAUSE_OTHER,
+        CAUSE_COUNT
+    };
+
+    struct config_t
+    {
+        std::string policy = "greedy";
+        uint32_t episodes = 100; // per level
+        uint32_t seed = 1;
+        uint32_t maxTicks = 24 * 60 * 5;
+        int skill = 0;
+        int firstLevel = 0;
+        int lastLevel = -1; // inclusive; -1 for the last one
+        unsigned jobs = 0;  // 0 for all cores
+    };
+
+    struct levelReport_t
+    {
+        int level = 0;
+        uint32_t episodes = 0;
+        uint32_t cleared = 0;
+        uint32_t unfinished = 0; // maxTicks reached
+        uint32_t deaths[CAUSE_COUNT] = {};
+        uint64_t clearTicks = 0;
+        std::vector<uint32_t> clearTimes;
+        // mean health per second, over the episodes still running
+        std::vector<uint64_t> healthSum;
+        std::vector<uint32_t> healthCount;
+        void merge(const levelReport_t &other);
+    };
+
+    CPlaytest(CMapArch &arch, const config_t &config);
+    ~CPlaytest() {};
+
+    bool run();
+    const std::vector<levelReport_t> &reports() const { return m_reports; }
+    bool writeCSV(const std::string &path) const;
+    bool writeJSON(const std::string &path) const;
+    const char *lastError() const { return m_lastError.c_str(); }
+    static const char *causeName(const int cause);
+
+private:
+    CMapArch &m_arch;
+    config_t m_config;
+    std::vector<levelReport_t> m_reports;
+    std::string m_lastError;
+    void worker(std::vector<levelReport_t> &reports, std::atomic<uint32_t> &next, const uint32_t total) const;
+    void playEpisode(CGame &game, IBotPolicy &bot, const int level, const uint32_t seed, levelReport_t &report) const;
+    static uint8_t classifyHurt(CGame &game, const bool trapped);
+    static uint32_t median(std::vector<uint32_t> values);
+};
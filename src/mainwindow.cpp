@@ -11,6 +11,7 @@
 #include <QScrollBar>
 #include <QInputDialog>
 #include <QLabel>
+#include <QApplication>
 #include "mapscroll.h"
 #include "mapwidget.h"
 #include "dlgattr.h"
@@ -18,6 +19,7 @@
 #include "dlgselect.h"
 #include "dlgtest.h"
 #include "tilebox.h"
+#include "minimap.h"
 #include "runtime/tilesdata.h"
 #include "dlgstat.h"
 #include "runtime/map.h"
@@ -25,6 +27,7 @@
 #include "keyvaluedialog.h"
 #include "runtime/statedata.h"
 #include "runtime/dirs.h"
+#include "runtime/analyzer.h"
 #include "mapprops.h"
 
 MainWindow::MainWindow(QWidget *parent)
@@ -53,6 +56,7 @@ MainWindow::MainWindow(QWidget *parent)
     initFileMenu();
     initMapShortcuts();
     initToolBar();
+    initViewMenu();
     updateMenus();
     setWindowIcon(QIcon(":/data/icons/CS3MapEdit-icon.png"));
     m_label = new QLabel("", ui->statusbar);
@@ -119,6 +123,26 @@ void MainWindow::initTilebox()
             tilebox, SLOT(setTile(int)));
 }
 
+void MainWindow::initViewMenu()
+{
+    ui->menuView->addSeparator();
+    QAction *zoomIn = ui->menuView->addAction(tr("Zoom In"));
+    zoomIn->setShortcut(QKeySequence::ZoomIn);
+    zoomIn->setStatusTip(tr("Show the map larger."));
+    connect(zoomIn, SIGNAL(triggered()), m_scrollArea, SLOT(zoomIn()));
+    QAction *zoomOut = ui->menuView->addAction(tr("Zoom Out"));
+    zoomOut->setShortcut(QKeySequence::ZoomOut);
+    zoomOut->setStatusTip(tr("Show more of the map."));
+    connect(zoomOut, SIGNAL(triggered()), m_scrollArea, SLOT(zoomOut()));
+
+    auto dock = new QDockWidget();
+    dock->setWindowTitle(tr("Overview"));
+    auto minimap = new CMiniMap(m_scrollArea, dock);
+    dock->setWidget(minimap);
+    addDockWidget(Qt::RightDockWidgetArea, dock);
+    ui->menuView->addAction(dock->toggleViewAction());
+}
+
 MainWindow::~MainWindow()
 {
     delete ui;
@@ -233,9 +257,42 @@ bool MainWindow::save()
 
     updateRecentFileActions();
     reloadRecentFileActions();
+    checkLevels();
     return true;
 }
 
+/**
+ * @brief Check that every level can be won; issues go to the status bar.
+ *        Runs after each save, one level per core.
+ */
+void MainWindow::checkLevels()
+{
+    const std::vector<levelAnalysis_t> results = m_doc.isMulti()
+                                                     ? CLevelAnalyzer::runAll(m_doc)
+                                                     : std::vector<levelAnalysis_t>{CLevelAnalyzer(*m_doc.map()).run()};
+    QStringList issues;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const levelAnalysis_t &result = results[i];
+        if (!result.hasIssues())
+            continue;
+        QStringList list;
+        if (!result.solvable)
+            list.push_back(tr("can't be won"));
+        if (!result.unreachableDiamonds.empty())
+            list.push_back(tr("%1 unreachable diamond(s)").arg(result.unreachableDiamonds.size()));
+        if (!result.unusedKeys.empty())
+            list.push_back(tr("%1 unused key(s)").arg(result.unusedKeys.size()));
+        for (const softlock_t &softlock : result.softlocks)
+            list.push_back(tr("softlock pushing %1,%2").arg(softlock.block.x).arg(softlock.block.y));
+        if (result.truncated)
+            list.push_back(tr("partial check"));
+        issues.push_back(tr("map %1: %2").arg(i + 1).arg(list.join(", ")));
+    }
+    if (!issues.isEmpty())
+        setStatus(issues.join("; "));
+}
+
 bool MainWindow::saveAs()
 {
     bool result = false;
@@ -263,6 +320,8 @@ bool MainWindow::saveAs()
     {
         m_doc.setFilename(fileName);
         result = m_doc.write();
+        if (result)
+            checkLevels();
     }
 
     updateTitle();
@@ -927,6 +986,7 @@ void MainWindow::on_actionEdit_First_Map_triggered()
 void MainWindow::on_actionFile_Generate_Report_triggered()
 {
     QStringList filters;
+    filters << tr("Text report (*.txt)") << tr("JSON report (*.json)");
     QString suffix = "txt";
     QString fileName = "";
 
@@ -937,6 +997,13 @@ void MainWindow::on_actionFile_Generate_Report_triggered()
     dlg->setAcceptMode(QFileDialog::AcceptSave);
     dlg->setDefaultSuffix(suffix);
     dlg->selectFile(tr("report.txt"));
+    // the report format follows the file extension
+    connect(dlg, &QFileDialog::filterSelected, dlg, [dlg, filters](const QString &filter)
+    {
+        const QString suffix = filter == filters[1] ? "json" : "txt";
+        dlg->setDefaultSuffix(suffix);
+        dlg->selectFile(tr("report.") + suffix);
+    });
     if (dlg->exec())
     {
         QStringList fileNames = dlg->selectedFiles();
@@ -989,13 +1056,37 @@ void MainWindow::on_actionExport_Screenshots_triggered()
         QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks
     );
 
-    if (!folder.isEmpty()) {
-        QMessageBox::information(this, "Export", "Exporting to:\n" + folder);
-        for (size_t i=0; i < m_doc.size();++i) {
-            CMap *map = m_doc.at(i);
-            const QString filename = folder + QString("/level%1.png").arg(i + 1, 2, 10, QLatin1Char('0')) ;
-            generateScreenshot(filename, map, 24,24);
-        }
+    if (folder.isEmpty()) {
+        return;
+    }
+
+    const QStringList areas = {
+        tr("Start area of each map"),
+        tr("Whole maps"),
+        tr("Start area of each map, and a contact sheet"),
+        tr("Whole maps, and a contact sheet"),
+    };
+    bool ok = false;
+    const QString area = QInputDialog::getItem(this, tr("Export Screenshots"), tr("Export:"), areas, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    const int choice = areas.indexOf(area);
+    screenshotOptions_t options;
+    options.wholeMap = choice == 1 || choice == 3;
+    options.atlas = choice >= 2;
+
+    std::vector<CMap *> maps;
+    for (size_t i=0; i < m_doc.size();++i) {
+        maps.push_back(m_doc.at(i));
+    }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const int written = exportScreenshots(maps, folder, options);
+    QApplication::restoreOverrideCursor();
+    if (written != static_cast<int>(maps.size())) {
+        warningMessage(tr("Exported %1 of %2 screenshots to:\n%3").arg(written).arg(maps.size()).arg(folder));
+    } else {
+        QMessageBox::information(this, tr("Export"), tr("Exported %1 screenshots to:\n%2").arg(written).arg(folder));
     }
 }
 
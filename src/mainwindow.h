@@ -81,6 +81,7 @@ private:
     void warningMessage(const QString message);
     bool saveAs();
     bool save();
+    void checkLevels();
     void open(QString);
     bool updateTitle();
     void updateMenus();
@@ -91,6 +92,7 @@ private:
     void initTilebox();
     void initMapShortcuts();
     void initToolBar();
+    void initViewMenu();
     int currentTool();
 
     enum {
@@ -19,6 +19,9 @@ SOURCES += \
     runtime/actor.cpp \
     runtime/randomz.cpp \
     runtime/animator.cpp \
+    runtime/background.cpp \
+    runtime/bandrenderer.cpp \
+    runtime/blitter.cpp \
     runtime/game.cpp \
     runtime/game_ai.cpp \
     runtime/gameui.cpp \
@@ -31,19 +34,27 @@ SOURCES += \
     runtime/shared/Frame.cpp \
     runtime/shared/FrameSet.cpp \
     runtime/shared/PngMagic.cpp \
+    runtime/shared/PngEncoder.cpp \
+    runtime/shared/Upscale.cpp \
     runtime/shared/helper.cpp \
     runtime/map.cpp \
     runtime/layer.cpp \
     runtime/shared/qtgui/qfilewrap.cpp \
     runtime/shared/qtgui/qthelper.cpp \
+    runtime/shared/qtgui/qrendertarget.cpp \
     runtime/tilesdata.cpp \
     runtime/tilesdebug.cpp \
     runtime/states.cpp \
     runtime/statedata.cpp \
     runtime/chars.cpp \
     runtime/recorder.cpp \
+    runtime/rewind.cpp \
+    runtime/prefetch.cpp \
+    runtime/analyzer.cpp \
+    runtime/archreport.cpp \
     runtime/gamestats.cpp \
     runtime/colormap.cpp \
+    runtime/tintcache.cpp \
     runtime/strhelper.cpp \
     runtime/boss.cpp \
     dlgattr.cpp \
@@ -53,11 +64,14 @@ SOURCES += \
     dlgstat.cpp \
     dlgtest.cpp \
     tilebox.cpp \
+    tilemips.cpp \
     keyvaluedialog.cpp \
     main.cpp \
     mainwindow.cpp \
     mapfile.cpp \
     mapscroll.cpp \
+    minimap.cpp \
+    overview.cpp \
     mapwidget.cpp \
     report.cpp \
     mapprops.cpp
@@ -74,23 +88,30 @@ HEADERS += \
     runtime/anniedata.h \
     runtime/animzdata.h \
     runtime/animator.h \
+    runtime/background.h \
+    runtime/bandrenderer.h \
+    runtime/blitter.h \
     runtime/game.h \
     runtime/gameui.h \
     runtime/gamemixin.h \
     runtime/level.h \
     runtime/maparch.h \
+    runtime/levelmeta.h \
     runtime/shared/DotArray.h \
     runtime/shared/FileWrap.h \
     runtime/shared/FileMem.h \
     runtime/shared/Frame.h \
     runtime/shared/FrameSet.h \
     runtime/shared/PngMagic.h \
+    runtime/shared/PngEncoder.h \
+    runtime/shared/Upscale.h \
     runtime/shared/helper.h \
     runtime/map.h \
     runtime/layer.h \
     runtime/shared/qtgui/cheat.h \
     runtime/shared/qtgui/qfilewrap.h \
     runtime/shared/qtgui/qthelper.h \
+    runtime/shared/qtgui/qrendertarget.h \
     runtime/sprtypes.h \
     runtime/tilesdata.h \
     runtime/tilesdebug.h \
@@ -101,14 +122,20 @@ HEADERS += \
     runtime/events.h \
     runtime/chars.h \
     runtime/recorder.h \
+    runtime/rewind.h \
+    runtime/prefetch.h \
+    runtime/analyzer.h \
+    runtime/archreport.h \
     runtime/gamesfx.h \
     runtime/gamestats.h \
     runtime/colormap.h \
+    runtime/tintcache.h \
     runtime/strhelper.h \
     runtime/attr.h \
     runtime/logger.h \
     runtime/boss.h \
     runtime/rect.h \
+    runtime/statehash.h \
     runtime/gamesfx.h \
     runtime/joyaim.h \
     app_version.h \
@@ -121,9 +148,12 @@ HEADERS += \
     mainwindow.h \
     mapfile.h \
     mapscroll.h \
+    minimap.h \
+    overview.h \
     mapwidget.h \
     report.h \
     tilebox.h \
+    tilemips.h \
     keyvaluedialog.h \
     mapprops.h
 
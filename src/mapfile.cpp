@@ -1,5 +1,6 @@
 #include "mapfile.h"
 #include "runtime/map.h"
+#include "runtime/game.h"
 
 CMapFile::CMapFile() : CMapArch()
 {
@@ -26,6 +27,19 @@ bool CMapFile::write()
     const std::string fname = filename().toLocal8Bit().toStdString();
     if (isMulti())
     {
+        // precompute what the runtime would scan for at level start;
+        // unchanged maps keep their entry, only edited ones are scanned
+        std::vector<levelMeta_t> metas;
+        metas.reserve(m_maps.size());
+        for (const auto &map : m_maps) {
+            map->updateCrc();
+            const levelMeta_t *cached = meta(*map);
+            metas.emplace_back(cached ? *cached : CGame::buildLevelMeta(*map));
+        }
+        clearMeta();
+        for (size_t i = 0; i < m_maps.size(); ++i) {
+            setMeta(*m_maps[i], metas[i]);
+        }
         result = CMapArch::write(fname.c_str());
     }
     else
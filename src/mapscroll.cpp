@@ -23,6 +23,67 @@ CMapScroll::CMapScroll(QWidget *parent)
     update();
 }
 
+CMapWidget *CMapScroll::mapWidget() const
+{
+    return dynamic_cast<CMapWidget *>(viewport());
+}
+
+/**
+ * @brief The cells in view, in map coordinates
+ *
+ * @return QRect
+ */
+QRect CMapScroll::visibleCells() const
+{
+    const QSize sz = viewport()->size();
+    return QRect(horizontalScrollBar()->value(), verticalScrollBar()->value(),
+                 (sz.width() + gridSize() - 1) / gridSize(), (sz.height() + gridSize() - 1) / gridSize());
+}
+
+void CMapScroll::zoomIn()
+{
+    setZoom(m_zoom - 1);
+}
+
+void CMapScroll::zoomOut()
+{
+    setZoom(m_zoom + 1);
+}
+
+/**
+ * @brief Change the size of the cells, keeping the cell at the center
+ *        of the view where it was
+ *
+ * @param zoom 0 for full size, up to CMapWidget::MAX_ZOOM
+ */
+void CMapScroll::setZoom(int zoom)
+{
+    zoom = std::clamp(zoom, 0, static_cast<int>(CMapWidget::MAX_ZOOM));
+    if (zoom == m_zoom) {
+        return;
+    }
+    const QRect cells = visibleCells();
+    const QPoint center = cells.center();
+    m_zoom = zoom;
+    mapWidget()->setZoom(zoom);
+    updateScrollbars();
+    centerOn(center.x(), center.y());
+    viewport()->update();
+}
+
+/**
+ * @brief Scroll so that a cell shows at the center of the view
+ *
+ * @param x
+ * @param y
+ */
+void CMapScroll::centerOn(int x, int y)
+{
+    const QSize sz = viewport()->size();
+    horizontalScrollBar()->setValue(x - sz.width() / gridSize() / 2);
+    verticalScrollBar()->setValue(y - sz.height() / gridSize() / 2);
+}
+
 void CMapScroll::resizeEvent(QResizeEvent *event)
 {
     CMapWidget *glw = dynamic_cast<CMapWidget *>(viewport());
@@ -36,17 +97,24 @@ void CMapScroll::paintEvent(QPaintEvent *event)
     glw->paintEvent(event);
 }
 
+void CMapScroll::scrollContentsBy(int dx, int dy)
+{
+    // move what is on screen, only the strip exposed gets repainted;
+    // the widget moves its own framebuffer on the next refresh
+    viewport()->scroll(dx * gridSize(), dy * gridSize());
+}
+
 void CMapScroll::updateScrollbars()
 {
     QSize sz = size();
-    int h = sz.width() / GRID_SIZE;
-    int v = sz.height() / GRID_SIZE;
+    int h = sz.width() / gridSize();
+    int v = sz.height() / gridSize();
 
     horizontalScrollBar()->setRange(0, m_mapLen - h);
     verticalScrollBar()->setRange(0, m_mapHei - v);
 
-    horizontalScrollBar()->setPageStep(STEPS);
-    verticalScrollBar()->setPageStep(STEPS);
+    horizontalScrollBar()->setPageStep(STEPS << m_zoom);
+    verticalScrollBar()->setPageStep(STEPS << m_zoom);
 }
 
 void CMapScroll::mousePressEvent(QMouseEvent *event)
@@ -88,8 +156,8 @@ void CMapScroll::mouseReleaseEvent(QMouseEvent *event)
 
 void CMapScroll::mouseMoveEvent(QMouseEvent *event)
 {
-    m_mouse.x = event->pos().x() / GRID_SIZE + horizontalScrollBar()->value();
-    m_mouse.y = event->pos().y() / GRID_SIZE + verticalScrollBar()->value();
+    m_mouse.x = event->pos().x() / gridSize() + horizontalScrollBar()->value();
+    m_mouse.y = event->pos().y() / gridSize() + verticalScrollBar()->value();
     QString str = QString("x: %1 y: %2").arg(m_mouse.x).arg(m_mouse.y);
     emit statusChanged(str);
     if (m_mouse.lButton && (m_mouse.x >= 0 && m_mouse.y >= 0))
@@ -102,6 +170,7 @@ void CMapScroll::wheelEvent(QWheelEvent *event)
 {
     QPoint numPixels = event->pixelDelta();
     QPoint numDegrees = event->angleDelta() / 8;
+    const int steps = STEPS << m_zoom;
 
     enum
     {
@@ -119,15 +188,26 @@ void CMapScroll::wheelEvent(QWheelEvent *event)
         dir = numDegrees.ry() > 0 ? UP : DOWN;
     }
 
+    // ctrl+wheel zooms
+    if (event->modifiers() & Qt::ControlModifier)
+    {
+        if (dir == UP)
+            zoomIn();
+        else if (dir == DOWN)
+            zoomOut();
+        event->accept();
+        return;
+    }
+
     int val = verticalScrollBar()->value();
     if (dir == UP)
     {
-        val -= STEPS;
+        val -= steps;
         val = std::max(0, val);
     }
     else if (dir == DOWN)
     {
-        val += STEPS;
+        val += steps;
         val = std::min(val, verticalScrollBar()->maximum());
     }
     verticalScrollBar()->setValue(val);
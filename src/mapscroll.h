@@ -4,17 +4,26 @@
 #include <QAbstractScrollArea>
 class QWidget;
 class CMap;
+class CMapWidget;
 
 class CMapScroll : public QAbstractScrollArea
 {
     Q_OBJECT
 public:
     explicit CMapScroll(QWidget *parent = nullptr);
+    CMapWidget *mapWidget() const;
+    QRect visibleCells() const;
+    int zoom() const { return m_zoom; }
 
 signals:
     void statusChanged(const QString str);
     void leftClickedAt(int x, int y);
 
+public slots:
+    void zoomIn();
+    void zoomOut();
+    void centerOn(int x, int y);
+
 protected slots:
     void newMapSize(int len, int hei);
     void newMap(CMap *map);
@@ -26,8 +35,11 @@ protected:
     virtual void mousePressEvent(QMouseEvent *event) override;
     virtual void mouseReleaseEvent(QMouseEvent *event) override;
     virtual void mouseMoveEvent(QMouseEvent *event) override;
+    virtual void scrollContentsBy(int dx, int dy) override;
 
     void updateScrollbars();
+    void setZoom(int zoom);
+    int gridSize() const { return GRID_SIZE >> m_zoom; }
 
     typedef struct
     {
@@ -41,6 +53,7 @@ protected:
 
     int m_mapLen;
     int m_mapHei;
+    int m_zoom = 0; // each step halves the cells
     enum
     {
         GRID_SIZE = 32,
@@ -1,15 +1,23 @@
 #include "mapwidget.h"
 #include "qpainter.h"
 #include "runtime/shared/qtgui/qfilewrap.h"
+#include "runtime/shared/qtgui/qrendertarget.h"
 #include "runtime/shared/FrameSet.h"
 #include "runtime/shared/Frame.h"
 #include "runtime/map.h"
 #include "mapscroll.h"
 #include "runtime/animator.h"
+#include "runtime/bandrenderer.h"
+#include "tilemips.h"
+#include "overview.h"
 #include "runtime/states.h"
 #include "runtime/statedata.h"
 #include "runtime/attr.h"
 #include <QScrollBar>
+#include <QPaintEvent>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 #define RANGE(_x, _min, _max) (_x >= _min && _x <= _max)
 
@@ -17,15 +25,24 @@ CMapWidget::CMapWidget(QWidget *parent)
     : QWidget{parent}
 {
     m_animator = new CAnimator();
+    m_target = new CRenderTarget();
+    m_bands = new CBandRenderer();
+    m_overview = new COverview();
     m_timer.setInterval(1000 / TICK_RATE);
     m_timer.start();
     preloadAssets();
-    connect(&m_timer, SIGNAL(timeout()), this, SLOT(update()));
+    m_animator->setFrameSets(m_tiles, m_animz, false);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(tick()));
 }
 
 CMapWidget::~CMapWidget()
 {
     m_timer.stop();
+    delete m_overview;
+    delete m_tileMips;
+    delete m_animzMips;
+    delete m_bands;
+    delete m_target;
 }
 
 void CMapWidget::setMap(CMap *pMap)
@@ -33,6 +50,16 @@ void CMapWidget::setMap(CMap *pMap)
     m_map = pMap;
 }
 
+/**
+ * @brief Show the tiles smaller; the scroll area keeps its scrollbars in step
+ *
+ * @param zoom 0 for full size, each step halves the tiles
+ */
+void CMapWidget::setZoom(const int zoom)
+{
+    m_zoom = std::clamp(zoom, 0, static_cast<int>(MAX_ZOOM));
+}
+
 void CMapWidget::showGrid(bool show)
 {
     m_showGrid = show;
@@ -68,6 +95,12 @@ void CMapWidget::preloadAssets()
         }
     }
 
+    // reduced tiles for the zoomed out views
+    m_tileMips = new CTileMips();
+    m_tileMips->build(*m_tiles);
+    m_animzMips = new CTileMips();
+    m_animzMips->build(*m_animz);
+
     const char fontName [] = ":/data/bitfont.bin";
     int size = 0;
     if (file.open(fontName, "rb")) {
@@ -81,14 +114,13 @@ void CMapWidget::preloadAssets()
     }
 }
 
-void CMapWidget::paintEvent(QPaintEvent *)
+/**
+ * @brief Advance the animations and repaint only the cells that changed
+ *
+ */
+void CMapWidget::tick()
 {
-    const QSize widgetSize = size();
-    const int width = widgetSize.width() / 2 + TILE_SIZE;
-    const int height = widgetSize.height() / 2 + TILE_SIZE;
-
     if (!m_map) {
-        qDebug("map is null");
         return;
     }
 
@@ -98,21 +130,286 @@ void CMapWidget::paintEvent(QPaintEvent *)
         m_animator->animate();
     }
 
-    // draw screen
-    CFrame bitmap(width, height);
-    drawScreen(bitmap);
-    if (m_showGrid) {
-        drawGrid(bitmap);
+    const QRect dirty = refresh();
+    if (!dirty.isEmpty()) {
+        update(QRect(dirty.x() * 2, dirty.y() * 2, dirty.width() * 2, dirty.height() * 2));
     }
+}
 
-    // show the screen
-    const QImage & img = QImage(reinterpret_cast<uint8_t*>(bitmap.getRGB().data()), bitmap.width(), bitmap.height(), QImage::Format_RGBX8888);
-    const QPixmap & pixmap = QPixmap::fromImage(img.scaled(QSize(width * 2, height * 2)));
+void CMapWidget::paintEvent(QPaintEvent *event)
+{
+    if (!m_map) {
+        qDebug("map is null");
+        return;
+    }
+
+    // exposed or resized: bring the framebuffer up to date; cells that
+    // changed outside of this event get painted with the next one
+    const QRect dirty = refresh();
+    if (!dirty.isEmpty()) {
+        update(QRect(dirty.x() * 2, dirty.y() * 2, dirty.width() * 2, dirty.height() * 2));
+    }
+
+    // show the requested part of the screen, at twice the size
+    const QRect target = event->rect();
+    const QRect source = QRect(target.x() / 2, target.y() / 2, (target.width() + 3) / 2, (target.height() + 3) / 2);
     QPainter p(this);
-    p.drawPixmap(0, 0, pixmap);
+    m_target->draw(p, source);
     p.end();
 }
 
+/**
+ * @brief Invalidate every cell: the next refresh redraws the whole screen
+ *
+ */
+void CMapWidget::invalidate()
+{
+    std::fill(m_cells.begin(), m_cells.end(), CELL_NONE);
+}
+
+/**
+ * @brief Move the cells already drawn; the cells exposed are invalidated.
+ *        The widget itself is scrolled by CMapScroll::scrollContentsBy.
+ *
+ * @param dx columns to move right, negative to move left
+ * @param dy rows to move down, negative to move up
+ */
+void CMapWidget::scrollCells(const int dx, const int dy)
+{
+    const int cols = m_target->width() / TILE_SIZE;
+    const int rows = m_target->height() / TILE_SIZE;
+    if (std::abs(dx) >= cols || std::abs(dy) >= rows) {
+        invalidate();
+        return;
+    }
+
+    // move the pixels, in an order that doesn't overwrite rows not yet moved
+    const int keptCols = cols - std::abs(dx);
+    const int keptRows = rows - std::abs(dy);
+    const int sx = std::max(0, -dx);
+    const int sy = std::max(0, -dy);
+    const int tx = std::max(0, dx);
+    const int ty = std::max(0, dy);
+    const int pitch = m_target->width();
+    uint32_t *rgb = m_target->frame().getRGB().data();
+    const size_t rowSize = keptCols * TILE_SIZE * sizeof(uint32_t);
+    const int lines = keptRows * TILE_SIZE;
+    for (int i = 0; i < lines; ++i) {
+        const int line = dy > 0 ? lines - 1 - i : i;
+        memmove(rgb + tx * TILE_SIZE + (ty * TILE_SIZE + line) * pitch,
+                rgb + sx * TILE_SIZE + (sy * TILE_SIZE + line) * pitch, rowSize);
+    }
+
+    // and their states
+    std::vector<uint32_t> cells(m_cells.size(), CELL_NONE);
+    for (int y = 0; y < keptRows; ++y) {
+        for (int x = 0; x < keptCols; ++x) {
+            cells[(x + tx) + (y + ty) * cols] = m_cells[(x + sx) + (y + sy) * cols];
+        }
+    }
+    m_cells.swap(cells);
+}
+
+/**
+ * @brief Redraw the cells whose state changed since the last refresh
+ *
+ * @return QRect area redrawn, in framebuffer pixels
+ */
+QRect CMapWidget::refresh()
+{
+    const QSize widgetSize = size();
+    const int width = widgetSize.width() / 2 + TILE_SIZE;
+    const int height = widgetSize.height() / 2 + TILE_SIZE;
+    const bool resized = m_target->resize(width, height, 2);
+    if (resized) {
+        m_target->frame().fill(WHITE);
+        m_cells.assign((width / TILE_SIZE) * (height / TILE_SIZE), CELL_NONE);
+    }
+
+    CMapScroll *scr = static_cast<CMapScroll*>(parent());
+    const int mx = scr->horizontalScrollBar()->value();
+    const int my = scr->verticalScrollBar()->value();
+    if (m_zoom != 0) {
+        return refreshOverview(mx, my, resized);
+    }
+
+    // a new map or a resized map changes every cell; a scroll moves
+    // what is already drawn and only exposes a strip
+    if (m_drawnMap != m_map || m_drawnLen != m_map->len() || m_drawnHei != m_map->hei() || m_drawnZoom != 0) {
+        m_drawnZoom = 0;
+        m_drawnMap = m_map;
+        m_drawnLen = m_map->len();
+        m_drawnHei = m_map->hei();
+        m_drawnX = mx;
+        m_drawnY = my;
+        invalidate();
+    } else if (m_drawnX != mx || m_drawnY != my) {
+        scrollCells(m_drawnX - mx, m_drawnY - my);
+        m_drawnX = mx;
+        m_drawnY = my;
+    }
+
+    const auto & states = m_map->statesConst();
+    const uint16_t startPos = states.getU(POS_ORIGIN);
+    const uint16_t exitPos = states.getU(POS_EXIT);
+    const int cols = width / TILE_SIZE;
+    const int rows = height / TILE_SIZE;
+    // each band of rows owns its cells and their pixels: tiles, labels
+    // and grid are drawn without locking, on several threads
+    std::vector<QRect> bandDirty(m_bands->bandCount(rows));
+    CFrame & bitmap = m_target->frame();
+    m_bands->run(rows, [&](const int band, const int first, const int last) {
+        QRect & dirty = bandDirty[band];
+        for (int y=first; y < last; ++y) {
+            for (int x=0; x < cols; ++x) {
+                const uint32_t state = cellState(x, y, startPos, exitPos);
+                uint32_t & cell = m_cells[x + y * cols];
+                if (cell == state) {
+                    continue;
+                }
+                cell = state;
+                drawCell(bitmap, x, y, state);
+                dirty |= QRect(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+            }
+        }
+    });
+    QRect dirty;
+    for (const QRect & rect : bandDirty) {
+        dirty |= rect;
+    }
+    return dirty;
+}
+
+/**
+ * @brief Zoomed out: show the part of the overview in view. The overview
+ *        redraws the chunks that changed; only those are copied again,
+ *        unless the view moved.
+ *
+ * @param mx first column in view
+ * @param my first row in view
+ * @param resized the framebuffer was just resized
+ * @return QRect area redrawn, in framebuffer pixels
+ */
+QRect CMapWidget::refreshOverview(const int mx, const int my, const bool resized)
+{
+    const int size = cellSize();
+    COverview::Rect cells;
+    const bool changed = m_overview->sync(*m_map, *m_tileMips, m_animate ? m_animzMips : nullptr, m_animator, size, cells);
+    const QRect area(0, 0, m_target->width(), m_target->height());
+    QRect dirty;
+    if (resized || m_drawnZoom != m_zoom || m_drawnMap != m_map || m_drawnLen != m_map->len() ||
+        m_drawnHei != m_map->hei() || m_drawnX != mx || m_drawnY != my) {
+        m_drawnZoom = m_zoom;
+        m_drawnMap = m_map;
+        m_drawnLen = m_map->len();
+        m_drawnHei = m_map->hei();
+        m_drawnX = mx;
+        m_drawnY = my;
+        dirty = area;
+    } else if (changed) {
+        dirty = QRect((cells.x - mx) * size, (cells.y - my) * size, cells.width * size, cells.height * size) & area;
+    }
+    if (dirty.isEmpty()) {
+        return dirty;
+    }
+
+    // copy from the overview, white past the edges of the map
+    const int pitch = m_target->width();
+    uint32_t *rgb = m_target->frame().getRGB().data();
+    const uint32_t *src = m_overview->pixels();
+    const int srcWidth = m_overview->width();
+    const int srcHeight = m_overview->height();
+    const int sx = mx * size + dirty.x();
+    for (int y = dirty.top(); y <= dirty.bottom(); ++y) {
+        uint32_t *dest = rgb + dirty.x() + y * pitch;
+        const int sy = my * size + y;
+        const int n = sy < srcHeight ? std::clamp(srcWidth - sx, 0, dirty.width()) : 0;
+        if (n) {
+            memcpy(dest, src + sx + sy * srcWidth, n * sizeof(uint32_t));
+        }
+        std::fill(dest + n, dest + dirty.width(), WHITE);
+    }
+    return dirty;
+}
+
+/**
+ * @brief Everything that decides what a cell looks like, packed
+ *
+ * @param x screen column
+ * @param y screen row
+ * @param startPos
+ * @param exitPos
+ * @return uint32_t CELL_xxx
+ */
+uint32_t CMapWidget::cellState(const int x, const int y, const uint16_t startPos, const uint16_t exitPos)
+{
+    const int mx = m_drawnX + x;
+    const int my = m_drawnY + y;
+    if (mx >= m_map->len() || my >= m_map->hei()) {
+        return CELL_BLANK;
+    }
+    const uint8_t tileID = m_map->at(mx, my);
+    const uint32_t j = m_animate ? m_animator->at(tileID) : static_cast<uint8_t>(NO_ANIMZ);
+    const uint8_t a = m_map->getAttr(mx, my);
+    uint32_t state = (tileID << CELL_TILE_SHIFT) | (j << CELL_FRAME_SHIFT) | (a << CELL_ATTR_SHIFT);
+    const uint16_t key = CMap::toKey(mx, my);
+    if (startPos && startPos == key) {
+        state |= CELL_START;
+    }
+    if (exitPos && exitPos == key) {
+        state |= CELL_EXIT;
+    }
+    if (a != 0 && a == m_attr) {
+        state |= CELL_BLINK;
+        if (((m_ticks >> 2) & 1) == 1) {
+            state |= CELL_BLINK_ALT;
+        }
+    } else if (m_hx != 0 && m_hy != 0 && mx == m_hx && my == m_hy) {
+        state |= CELL_HIGHLIGHT;
+    }
+    if (m_showGrid) {
+        state |= CELL_GRID;
+    }
+    return state;
+}
+
+void CMapWidget::drawCell(CFrame &bitmap, const int x, const int y, const uint32_t state)
+{
+    const Rect rect{.x=x*TILE_SIZE, .y=y*TILE_SIZE, .width=TILE_SIZE, .height=TILE_SIZE};
+    if (state & CELL_BLANK) {
+        drawRect(bitmap, rect, WHITE, true);
+        return;
+    }
+
+    const char hexchar[] = "0123456789ABCDEF";
+    const uint8_t tileID = (state >> CELL_TILE_SHIFT) & 0xff;
+    const uint8_t j = (state >> CELL_FRAME_SHIFT) & 0xff;
+    const uint8_t a = (state >> CELL_ATTR_SHIFT) & 0xff;
+    CFrame *tile = j == NO_ANIMZ ? (*m_tiles)[tileID] : m_animator->frame(tileID);
+    drawTile(bitmap, rect.x, rect.y, *tile, false);
+    if (state & CELL_START) {
+        drawRect(bitmap, rect, YELLOW, false);
+    }
+    if (state & CELL_EXIT) {
+        drawRect(bitmap, rect, RED, false);
+    }
+    if (a) {
+        char s[3];
+        s[0] = hexchar[a >> 4];
+        s[1] = hexchar[a & 0xf];
+        s[2] = 0;
+        drawFont(bitmap, rect.x, rect.y + 4, s, attr2color(a), true);
+    }
+    if (state & CELL_BLINK) {
+        drawRect(bitmap, rect, (state & CELL_BLINK_ALT) ? PINK : CYAN, false);
+    } else if (state & CELL_HIGHLIGHT) {
+        drawRect(bitmap, rect, CORAL, false);
+    }
+    if (state & CELL_GRID) {
+        drawGrid(bitmap, x, y);
+    }
+}
+
 void CMapWidget::drawRect(CFrame &frame, const Rect &rect, const uint32_t color, bool fill)
 {
     uint32_t *rgba = frame.getRGB().data();
@@ -142,69 +439,6 @@ void CMapWidget::drawRect(CFrame &frame, const Rect &rect, const uint32_t color,
     }
 }
 
-void CMapWidget::drawScreen(CFrame &bitmap)
-{
-    CMap *map = m_map;
-    auto & states = map->states();
-    const uint16_t startPos = states.getU(POS_ORIGIN);
-    const uint16_t exitPos = states.getU(POS_EXIT);
-
-    const int maxRows = bitmap.height() / TILE_SIZE;
-    const int maxCols = bitmap.width() / TILE_SIZE;
-    const int rows = std::min(maxRows, map->hei());
-    const int cols = std::min(maxCols, map->len());
-    CMapScroll *scr = static_cast<CMapScroll*>(parent());
-    const int mx = scr->horizontalScrollBar()->value();
-    const int my = scr->verticalScrollBar()->value();
-    const char hexchar[] = "0123456789ABCDEF";
-
-    CFrameSet & tiles = *m_tiles;
-    CFrameSet & animz = *m_animz;
-    bitmap.fill(WHITE);
-    for (int y=0; y < rows; ++y) {
-        if (y + my >= map->hei())
-        {
-            break;
-        }
-        for (int x=0; x < cols; ++x) {
-            if (x + mx >= map->len())
-            {
-                break;
-            }
-            uint8_t tileID = map->at(x + mx, y + my);
-            CFrame *tile;
-            int j = m_animate ? m_animator->at(tileID) : static_cast<uint8_t>(NO_ANIMZ);
-            if (j == NO_ANIMZ) {
-                tile = tiles[tileID];
-            } else {
-                tile = animz[j];
-            }
-            drawTile(bitmap, x * TILE_SIZE, y * TILE_SIZE, *tile, false);
-            if (startPos && startPos == CMap::toKey(mx+x, my+y)) {
-                drawRect(bitmap, Rect{.x=x*TILE_SIZE, .y=y*TILE_SIZE, .width=TILE_SIZE, .height=TILE_SIZE}, YELLOW, false);
-            }
-            if (exitPos && exitPos == CMap::toKey(mx+x, my+y)) {
-                drawRect(bitmap, Rect{.x=x*TILE_SIZE, .y=y*TILE_SIZE, .width=TILE_SIZE, .height=TILE_SIZE}, RED, false);
-            }
-
-            uint8_t a = map->getAttr(mx+x, my+y);
-            if (a) {
-                char s[3];
-                s[0] = hexchar[a >> 4];
-                s[1] = hexchar[a & 0xf];
-                s[2] = 0;
-                drawFont(bitmap, x*TILE_SIZE, y*TILE_SIZE + 4, s, attr2color(a), true);
-            }
-            if (a != 0 && a == m_attr) {
-                bool alt = ((m_ticks >> 2) & 1) == 1;
-                drawRect(bitmap, Rect{.x=x*TILE_SIZE, .y=y*TILE_SIZE, .width=TILE_SIZE, .height=TILE_SIZE}, alt ? PINK : CYAN, false);
-            } else if (m_hx != 0 && m_hy != 0 && mx + x == m_hx && my + y == m_hy) {
-                drawRect(bitmap, Rect{.x=x*TILE_SIZE, .y=y*TILE_SIZE, .width=TILE_SIZE, .height=TILE_SIZE}, CORAL, false);
-            }
-        }
-    }
-}
-
 uint32_t CMapWidget::attr2color(const uint8_t attr)
 {
     if (RANGE(attr, ATTR_MSG_MIN, ATTR_MSG_MAX)) {
@@ -230,35 +464,14 @@ uint32_t CMapWidget::attr2color(const uint8_t attr)
     }
 }
 
-void CMapWidget::drawGrid(CFrame & bitmap)
+void CMapWidget::drawGrid(CFrame & bitmap, const int x, const int y)
 {
-    CMap *map = m_map;
-    int maxRows = bitmap.height() / TILE_SIZE;
-    int maxCols = bitmap.width() / TILE_SIZE;
-    const int rows = std::min(maxRows, map->hei());
-    const int cols = std::min(maxCols, map->len());
-    CMapScroll *scr = static_cast<CMapScroll*>(parent());
-    const int mx = scr->horizontalScrollBar()->value();
-    const int my = scr->verticalScrollBar()->value();
-
-    for (int y=0; y < rows; ++y) {
-        if (y + my >= map->hei())
-        {
-            break;
-        }
-        for (int x=0; x < cols; ++x) {
-            if (x + mx >= map->len())
-            {
-                break;
-            }
-            for (unsigned int yy=0; yy< TILE_SIZE; yy += 2) {
-                for (unsigned int xx=0; xx< TILE_SIZE; xx += 2) {
-                    if (xx == 0 || yy == 0) {
-                        bitmap.at(x * TILE_SIZE + xx, y * TILE_SIZE + yy) = GRIDCOLOR;
-                        if (yy !=0) {
-                            break;
-                        }
-                    }
+    for (unsigned int yy=0; yy< TILE_SIZE; yy += 2) {
+        for (unsigned int xx=0; xx< TILE_SIZE; xx += 2) {
+            if (xx == 0 || yy == 0) {
+                bitmap.at(x * TILE_SIZE + xx, y * TILE_SIZE + yy) = GRIDCOLOR;
+                if (yy !=0) {
+                    break;
                 }
             }
         }
@@ -3,9 +3,15 @@
 
 #include "qtimer.h"
 #include <QWidget>
+#include <QRect>
+#include <vector>
 class CMap;
 class CFrame;
 class CFrameSet;
+class CRenderTarget;
+class CBandRenderer;
+class CTileMips;
+class COverview;
 class CAnimator;
 
 #define RGBA(R, G, B) (R | (G << 8) | (B << 16) | 0xff000000)
@@ -17,10 +23,20 @@ public:
     explicit CMapWidget(QWidget *parent = nullptr);
     virtual ~CMapWidget();
     void setMap(CMap *pMap);
+    CMap *map() const { return m_map; }
+    const CTileMips *tileMips() const { return m_tileMips; }
+    void setZoom(const int zoom);
+    int zoom() const { return m_zoom; }
+    int cellSize() const { return TILE_SIZE >> m_zoom; }
+
+    enum : int {
+        MAX_ZOOM = 4, // 1 pixel per tile in the framebuffer
+    };
 
 signals:
 
 protected slots:
+    void tick();
     void showGrid(bool show);
     void setAnimate(bool val);
     void highlight(uint8_t attr);
@@ -28,6 +44,20 @@ protected slots:
 
 protected:
     virtual void paintEvent(QPaintEvent *) ;
+    // what a cell shows: tile, animation frame, attribute and markers
+    enum:uint32_t {
+        CELL_TILE_SHIFT = 0,
+        CELL_FRAME_SHIFT = 8,
+        CELL_ATTR_SHIFT = 16,
+        CELL_START = 1 << 24,
+        CELL_EXIT = 1 << 25,
+        CELL_BLINK = 1 << 26,
+        CELL_BLINK_ALT = 1 << 27,
+        CELL_HIGHLIGHT = 1 << 28,
+        CELL_GRID = 1 << 29,
+        CELL_BLANK = 1 << 30, // outside the map
+        CELL_NONE = 0xffffffff,
+    };
     enum:int32_t {
         FONT_SIZE = 8,
         NO_ANIMZ = 255,
@@ -72,16 +102,34 @@ protected:
     };
 
     void preloadAssets();
-    inline void drawScreen(CFrame &bitmap);
+    QRect refresh();
+    QRect refreshOverview(const int mx, const int my, const bool resized);
+    void invalidate();
+    void scrollCells(const int dx, const int dy);
+    uint32_t cellState(const int x, const int y, const uint16_t startPos, const uint16_t exitPos);
+    void drawCell(CFrame &bitmap, const int x, const int y, const uint32_t state);
     inline void drawFont(CFrame & frame, int x, int y, const char *text, const uint32_t color, const bool alpha);
     inline void drawTile(CFrame & bitmap, const int x, const int y, CFrame & tile, const bool alpha);
-    inline void drawGrid(CFrame & bitmap);
+    inline void drawGrid(CFrame & bitmap, const int x, const int y);
     void drawRect(CFrame &frame, const Rect &rect, const uint32_t color, bool fill);
     uint32_t attr2color(const uint8_t attr);
 
     QTimer m_timer;
+    CRenderTarget *m_target = nullptr; // persistent framebuffer, half the widget size
+    std::vector<uint32_t> m_cells; // state of each cell in m_target
+    CBandRenderer *m_bands = nullptr; // redraws the cells by bands of rows
+    CMap *m_drawnMap = nullptr;
+    int m_drawnLen = 0;
+    int m_drawnHei = 0;
+    int m_drawnX = -1;
+    int m_drawnY = -1;
     CFrameSet *m_tiles = nullptr;
     CFrameSet *m_animz = nullptr;
+    CTileMips *m_tileMips = nullptr;
+    CTileMips *m_animzMips = nullptr;
+    COverview *m_overview = nullptr; // the map zoomed out
+    int m_zoom = 0; // tiles are TILE_SIZE >> m_zoom pixels
+    int m_drawnZoom = 0;
     uint8_t *m_fontData = nullptr;
     CMap *m_map = nullptr;
     CAnimator *m_animator = nullptr;
@@ -0,0 +1,111 @@
+#include "minimap.h"
+#include <algorithm>
+#include <QPainter>
+#include <QMouseEvent>
+#include "mapscroll.h"
+#include "mapwidget.h"
+#include "runtime/map.h"
+
+CMiniMap::CMiniMap(CMapScroll *view, QWidget *parent)
+    : QWidget{parent}, m_view(view)
+{
+    setMinimumSize(MAP_SIZE / 2, MAP_SIZE / 2);
+    connect(this, SIGNAL(centerOn(int, int)), m_view, SLOT(centerOn(int, int)));
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(tick()));
+    m_timer.setInterval(1000 / REFRESH_RATE);
+    m_timer.start();
+}
+
+CMiniMap::~CMiniMap()
+{
+    m_timer.stop();
+}
+
+QSize CMiniMap::sizeHint() const
+{
+    return QSize(MAP_SIZE, MAP_SIZE);
+}
+
+/**
+ * @brief Two pixels per tile when the whole map fits, one otherwise
+ *
+ * @return int
+ */
+int CMiniMap::cellSize() const
+{
+    const CMap *map = m_view->mapWidget()->map();
+    return map && map->len() * 2 <= width() && map->hei() * 2 <= height() ? 2 : 1;
+}
+
+QPoint CMiniMap::origin() const
+{
+    return QPoint(std::max(0, (width() - m_overview.width()) / 2),
+                  std::max(0, (height() - m_overview.height()) / 2));
+}
+
+/**
+ * @brief Bring the overview up to date with the map; repaint only if it
+ *        changed or the view moved
+ *
+ */
+void CMiniMap::tick()
+{
+    CMapWidget *widget = m_view->mapWidget();
+    if (!widget->map() || !widget->tileMips() || !isVisible()) {
+        return;
+    }
+    COverview::Rect dirty;
+    const bool changed = m_overview.sync(*widget->map(), *widget->tileMips(), nullptr, nullptr, cellSize(), dirty);
+    const QRect shown = m_view->visibleCells();
+    if (changed || shown != m_shown) {
+        m_shown = shown;
+        update();
+    }
+}
+
+void CMiniMap::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter p(this);
+    p.fillRect(rect(), Qt::black);
+    if (m_overview.width() == 0 || m_overview.height() == 0) {
+        return;
+    }
+    const QImage image(reinterpret_cast<const uchar *>(m_overview.pixels()),
+                       m_overview.width(), m_overview.height(),
+                       m_overview.width() * sizeof(uint32_t), QImage::Format_RGBX8888);
+    const QPoint at = origin();
+    p.drawImage(at, image);
+
+    // the part of the map in view
+    const int size = m_overview.cellSize();
+    p.setPen(Qt::yellow);
+    p.drawRect(at.x() + m_shown.x() * size, at.y() + m_shown.y() * size,
+               m_shown.width() * size - 1, m_shown.height() * size - 1);
+    p.end();
+}
+
+void CMiniMap::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        moveView(event->pos());
+    }
+}
+
+void CMiniMap::mouseMoveEvent(QMouseEvent *event)
+{
+    if (event->buttons() & Qt::LeftButton) {
+        moveView(event->pos());
+    }
+}
+
+void CMiniMap::moveView(const QPoint &pos)
+{
+    const int size = m_overview.cellSize();
+    if (size == 0) {
+        return;
+    }
+    const QPoint at = pos - origin();
+    emit centerOn(at.x() / size, at.y() / size);
+    tick();
+}
@@ -0,0 +1,48 @@
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+#include <QWidget>
+#include <QTimer>
+#include "overview.h"
+
+class CMapScroll;
+
+/**
+ * @brief The whole map at one or two pixels per tile, with the part in
+ *        view outlined; clicking or dragging moves the view.
+ */
+class CMiniMap : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit CMiniMap(CMapScroll *view, QWidget *parent = nullptr);
+    virtual ~CMiniMap();
+    virtual QSize sizeHint() const override;
+
+signals:
+    void centerOn(int x, int y);
+
+protected slots:
+    void tick();
+
+protected:
+    virtual void paintEvent(QPaintEvent *event) override;
+    virtual void mousePressEvent(QMouseEvent *event) override;
+    virtual void mouseMoveEvent(QMouseEvent *event) override;
+
+    int cellSize() const;
+    QPoint origin() const;
+    void moveView(const QPoint &pos);
+
+    enum {
+        REFRESH_RATE = 8,
+        MAP_SIZE = 256,
+    };
+
+    CMapScroll *m_view;
+    COverview m_overview;
+    QTimer m_timer;
+    QRect m_shown; // cells outlined
+};
+
+#endif // MINIMAP_H
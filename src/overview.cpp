@@ -0,0 +1,101 @@
+#include "overview.h"
+#include <algorithm>
+#include "tilemips.h"
+#include "runtime/map.h"
+#include "runtime/animator.h"
+
+/**
+ * @brief Redraw the chunks whose cells changed
+ *
+ * @param map
+ * @param tiles mip levels of the tiles
+ * @param animz mip levels of the animations, nullptr to show the tiles still
+ * @param animator
+ * @param cellSize pixels per tile: 1, 2, 4 or 8
+ * @param dirty cells redrawn
+ * @return true if anything was redrawn
+ */
+bool COverview::sync(const CMap &map, const CTileMips &tiles, const CTileMips *animz, const CAnimator *animator, const int cellSize, Rect &dirty)
+{
+    const int size = std::clamp(cellSize, 1, static_cast<int>(MAX_CELL_SIZE));
+    if (map.len() != m_len || map.hei() != m_hei || size != m_cellSize) {
+        m_len = map.len();
+        m_hei = map.hei();
+        m_cellSize = size;
+        m_pixels.assign(size_t(width()) * height(), 0);
+        m_drawn.assign(size_t(m_len) * m_hei, NOT_DRAWN);
+    }
+
+    int x0 = m_len;
+    int y0 = m_hei;
+    int x1 = 0;
+    int y1 = 0;
+    for (int cy = 0; cy < m_hei; cy += CHUNK_SIZE) {
+        for (int cx = 0; cx < m_len; cx += CHUNK_SIZE) {
+            const int cols = std::min(static_cast<int>(CHUNK_SIZE), m_len - cx);
+            const int rows = std::min(static_cast<int>(CHUNK_SIZE), m_hei - cy);
+            bool changed = false;
+            for (int y = cy; y < cy + rows && !changed; ++y) {
+                for (int x = cx; x < cx + cols; ++x) {
+                    if (m_drawn[x + y * m_len] != cellKey(map.at(x, y), animz, animator)) {
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+            if (!changed) {
+                continue;
+            }
+            drawChunk(map, tiles, animz, animator, cx, cy);
+            x0 = std::min(x0, cx);
+            y0 = std::min(y0, cy);
+            x1 = std::max(x1, cx + cols);
+            y1 = std::max(y1, cy + rows);
+        }
+    }
+    dirty = Rect{x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0)};
+    return dirty.width != 0;
+}
+
+/**
+ * @brief Have every chunk drawn again by the next sync
+ *
+ */
+void COverview::invalidate()
+{
+    std::fill(m_drawn.begin(), m_drawn.end(), NOT_DRAWN);
+}
+
+uint16_t COverview::cellKey(const uint8_t tileID, const CTileMips *animz, const CAnimator *animator) const
+{
+    if (animz && animator) {
+        const uint16_t j = animator->at(tileID);
+        if (j != NO_ANIMZ) {
+            return ANIMZ_KEY | j;
+        }
+    }
+    return tileID;
+}
+
+void COverview::drawChunk(const CMap &map, const CTileMips &tiles, const CTileMips *animz, const CAnimator *animator, const int cx, const int cy)
+{
+    const int size = m_cellSize;
+    const int pitch = width();
+    const int x1 = std::min(cx + static_cast<int>(CHUNK_SIZE), m_len);
+    const int y1 = std::min(cy + static_cast<int>(CHUNK_SIZE), m_hei);
+    for (int y = cy; y < y1; ++y) {
+        for (int x = cx; x < x1; ++x) {
+            const uint16_t key = cellKey(map.at(x, y), animz, animator);
+            m_drawn[x + y * m_len] = key;
+            const uint32_t *src = key & ANIMZ_KEY ? animz->level(key & 0xff, size) : tiles.level(key, size);
+            uint32_t *dest = &m_pixels[size_t(x) * size + size_t(y) * size * pitch];
+            for (int row = 0; row < size; ++row, dest += pitch) {
+                if (src) {
+                    std::copy(src + row * size, src + (row + 1) * size, dest);
+                } else {
+                    std::fill(dest, dest + size, 0xff000000);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef OVERVIEW_H
+#define OVERVIEW_H
+
+#include <cstdint>
+#include <vector>
+
+class CMap;
+class CAnimator;
+class CTileMips;
+
+/**
+ * @brief The whole map drawn at a few pixels per tile, from the tile
+ *        mip levels, and kept between refreshes.
+ *
+ * The map is split into chunks of 16x16 cells. A chunk is drawn again
+ * only when one of its cells shows something else than when it was
+ * last drawn, so editing the map only costs the chunks that were edited.
+ */
+class COverview
+{
+public:
+    using Rect = struct
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    bool sync(const CMap &map, const CTileMips &tiles, const CTileMips *animz, const CAnimator *animator, const int cellSize, Rect &dirty);
+    void invalidate();
+    inline const uint32_t *pixels() const { return m_pixels.data(); }
+    inline int width() const { return m_len * m_cellSize; }
+    inline int height() const { return m_hei * m_cellSize; }
+    inline int cellSize() const { return m_cellSize; }
+
+    enum : int {
+        CHUNK_SIZE = 16,
+        MAX_CELL_SIZE = 8,
+    };
+
+private:
+    enum : uint16_t {
+        NO_ANIMZ = 255,
+        ANIMZ_KEY = 0x100, // frame of m_animz rather than tile
+        NOT_DRAWN = 0xffff,
+    };
+
+    uint16_t cellKey(const uint8_t tileID, const CTileMips *animz, const CAnimator *animator) const;
+    void drawChunk(const CMap &map, const CTileMips &tiles, const CTileMips *animz, const CAnimator *animator, const int cx, const int cy);
+
+    std::vector<uint32_t> m_pixels;
+    std::vector<uint16_t> m_drawn; // key of each cell when last drawn
+    int m_len = 0;
+    int m_hei = 0;
+    int m_cellSize = 0;
+};
+
+#endif // OVERVIEW_H
@@ -1,8 +1,12 @@
 #include <QVector>
+#include "report.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
 #include "runtime/maparch.h"
 #include "mapfile.h"
 #include "runtime/map.h"
-#include "unordered_map"
 #include "runtime/shared/qtgui/qfilewrap.h"
 #include <stdint.h>
 #include "runtime/tilesdata.h"
@@ -13,172 +17,250 @@
 #include "runtime/shared/Frame.h"
 #include "runtime/game.h"
 #include "runtime/tilesdefs.h"
+#include "runtime/archreport.h"
+#include "tilemips.h"
 
 #define ALPHA 0xff000000
 #define BLACK 0xff000000
 
 bool generateReport(CMapFile & mf, const QString & filename) {
+    CArchReport report;
+    report.build(mf);
     QFileWrap file;
-    const int BUFSIZE = 4095;
-    char *tmp = new char[BUFSIZE + 1];
-    auto writeItem = [&file, tmp](auto str, auto v) {
-        sprintf(tmp, "  -- %-15s: %d\n", str, static_cast<int>(v));
-        file += tmp;
+    if (!file.open(filename, "wb")) {
+        return false;
+    }
+    const bool result = report.write(file, filename.endsWith(".json", Qt::CaseInsensitive));
+    file.close();
+    return result;
+}
+
+
+namespace ReportPrivate
+{
+    constexpr int TILE_SIZE = 16;
+    constexpr int MAX_FRAME_SIZE = 4096; // CFrame limit
+    constexpr int ATLAS_GAP = 4;
+
+    using area_t = struct
+    {
+        int x;
+        int y;
+        int cols;
+        int rows;
     };
 
-    std::unordered_map<uint16_t, std::string> labels;
-    const auto & keyOptions = getKeyOptions();
-    for (const auto &[v,k]: keyOptions) {
-        labels[k] =v;
+    bool loadTiles(CFrameSet &tiles)
+    {
+        QFileWrap file;
+        if (!file.open(":/data/tiles.obl", "rb")) {
+            return false;
+        }
+        const bool result = tiles.extract(file);
+        file.close();
+        return result;
     }
 
-    typedef std::unordered_map<uint8_t, uint32_t>  StatMap;
-    if (!file.open(filename, "wb")) {
-        delete []tmp;
-        return false;
-    }
+    /**
+     * @brief The part of the map around the player's start, at most maxCols x maxRows
+     *
+     * @param map
+     * @param maxRows
+     * @param maxCols
+     * @return area_t
+     */
+    area_t startArea(CMap &map, const int maxRows, const int maxCols)
+    {
+        const int rows = std::min(maxRows, map.hei());
+        const int cols = std::min(maxCols, map.len());
 
-    file += "Map List\n";
-    file += "========\n\n";
+        CStates & states = map.states();
+        const uint16_t startPos = states.getU(POS_ORIGIN);
 
-    for (size_t i=0; i < mf.size(); ++i) {
-        CMap *map = mf.at(i);
-        sprintf(tmp, "Level %.2lu: %s\n", i + 1, map->title());
-        file += tmp;
+        const Pos pos = startPos !=0 ? CMap::toPos(startPos): map.findFirst(TILES_ANNIE2);
+        const bool isFound = pos.x != CMap::NOT_FOUND || pos.y != CMap::NOT_FOUND;
+        const int lmx = std::max(0, isFound? pos.x - cols / 2 : 0);
+        const int lmy = std::max(0, isFound? pos.y - rows / 2 : 0);
+        const int mx = std::min(lmx, map.len() > cols ? map.len() - cols : 0);
+        const int my = std::min(lmy, map.hei() > rows ? map.hei() - rows : 0);
+        return area_t{mx, my, cols, rows};
     }
 
-    file += "\n";
-    file += "MapArch statistics\n";
-    file += "==================\n\n";
-
-    StatMap globalUsage;
-
-    for (size_t i=0; i < mf.size(); ++i) {
-        CMap *map = mf.at(i);
-        MapReport report = CGame::generateMapReport(*map);
-        StatMap usage;
-        int monsters=0;
-        int stops = 0;
-        for (int y=0;y < map->hei(); ++y) {
-            for (int x=0;x < map->len(); ++x) {
-                const auto &c = map->at(x,y);
-                ++usage[c];
-                ++globalUsage[c];
-                auto & def =getTileDef(c);
-                if (def.type == TYPE_MONSTER || def.type == TYPE_VAMPLANT) {
-                    ++monsters;
-                }
-                if (def.type == TYPE_STOP) {
-                    ++stops;
+    /**
+     * @brief Copy the tiles of an area to the top left corner of the bitmap, row by row
+     *
+     * @param bitmap at least area.cols x area.rows tiles
+     * @param tiles
+     * @param map
+     * @param area
+     */
+    void drawArea(CFrame &bitmap, CFrameSet &tiles, const CMap &map, const area_t &area)
+    {
+        const int pitch = bitmap.width();
+        uint32_t *rgba = bitmap.getRGB().data();
+        for (int row=0; row < area.rows; ++row) {
+            for (int col=0; col < area.cols; ++col) {
+                const uint8_t tile = map.at(col + area.x, row + area.y);
+                CFrame *frame = tile < tiles.getSize() ? tiles[tile] : nullptr;
+                uint32_t *dest = rgba + col * TILE_SIZE + row * TILE_SIZE * pitch;
+                for (int y=0; y < TILE_SIZE; ++y, dest += pitch) {
+                    if (!frame) {
+                        std::fill(dest, dest + TILE_SIZE, BLACK);
+                        continue;
+                    }
+                    const uint32_t *src = frame->getRGB().data() + y * TILE_SIZE;
+                    for (int x=0; x < TILE_SIZE; ++x) {
+                        dest[x] = src[x] | ALPHA;
+                    }
                 }
             }
         }
-        sprintf(tmp, "Level %.2lu: %s\n", i + 1, map->title());
-        file += tmp;
-        writeItem("Unique tiles", usage.size());
-        writeItem("Monsters", monsters);
-        writeItem("Attributes", map->attrs().size());
-        writeItem("Stops", stops);
-        sprintf(tmp, "  -- Size: %d x %d\n", map->len(), map->hei());
-        file += tmp;
-        writeItem("fruits", report.fruits);
-        writeItem("treasures", report.bonuses);
-        writeItem("secrets", report.secrets);
-
-        CStates &states = map->states();
-        std::vector<StateValuePair> pairs = states.getValues();
-        if (pairs.size()) {
-            file += "\nMeta-data\n";
-            for (const auto&item : pairs) {
-                const bool isStr = (item.key & 0xff) >= 0x80;
-                const std::string label = labels[item.key];
-                sprintf(tmp, "  -- %-12s %s", label.c_str(), isStr ? item.value.c_str() : item.tip.c_str());
-                file += tmp;
-                if (isStr)
-                    strncpy(tmp, "\n", BUFSIZE);
-                else
-                    sprintf(tmp, " [%s]\n", item.value.c_str());
-                file += tmp;
+    }
+
+    /**
+     * @brief The area at a few pixels per tile, for the contact sheet
+     *
+     * @param thumb cellSize * maxCols x cellSize * maxRows pixels
+     * @param pitch
+     * @param mips
+     * @param map
+     * @param area
+     * @param cellSize
+     */
+    void drawThumb(uint32_t *thumb, const int pitch, const CTileMips &mips, const CMap &map, const area_t &area, const int cellSize)
+    {
+        for (int row=0; row < area.rows; ++row) {
+            for (int col=0; col < area.cols; ++col) {
+                const uint32_t *src = mips.level(map.at(col + area.x, row + area.y), cellSize);
+                uint32_t *dest = thumb + col * cellSize + row * cellSize * pitch;
+                for (int y=0; y < cellSize; ++y, dest += pitch) {
+                    if (src) {
+                        std::copy(src + y * cellSize, src + (y + 1) * cellSize, dest);
+                    }
+                }
             }
         }
-        file += "\n-----------------------------------\n";
-        file += "\n";
     }
 
-    file += "Par time\n";
-    file += "==================\n\n";
-    for (size_t i=0; i < mf.size(); ++i) {
-        CMap *map = mf.at(i);
-        CStates &states = map->states();
-        uint16_t parTime= states.getU(PAR_TIME);
-        if (parTime == 0)
-            continue;
-        sprintf(tmp, "Level %.2lu: %s\n", i + 1, map->title());
-        file += tmp;
-        const int seconds = parTime % 60;
-        const int minutes = parTime / 60;
-        sprintf(tmp, "   PAR TIME:   %.2d:%.2d\n\n", minutes , seconds);
-        file += tmp;
+    bool writePng(CFrame &bitmap, const QString &filename, const unsigned jobs = 0)
+    {
+        pngOptions_t options;
+        options.jobs = jobs;
+        std::vector<uint8_t> png;
+        bitmap.toPng(png, {}, options);
+        QFileWrap file;
+        if (!file.open(filename, "wb")) {
+            return false;
+        }
+        const bool result = file.write(png.data(), png.size()) == IFILE_OK;
+        file.close();
+        return result;
     }
+};
 
-    sprintf(tmp, "\nGlobal Unique tiles: %lu\n", globalUsage.size());
-    file += tmp;
-    file.close();
-    delete []tmp;
-    return true;
-}
-
+using namespace ReportPrivate;
 
 void generateScreenshot(const QString &filename, CMap *map, const int maxRows, const int maxCols)
 {
-    CFrameSet * fs = new CFrameSet();
-    QFileWrap file;
-    if (file.open(":/data/tiles.obl", "rb")) {
-        qDebug("reading tiles");
-        if (fs->extract(file)) {
-            qDebug("extracted: %lu", fs->getSize());
-        }
-        file.close();
+    CFrameSet tiles;
+    if (!loadTiles(tiles)) {
+        qDebug("reading tiles failed");
+        return;
     }
+    CFrame bitmap(maxCols * TILE_SIZE, maxRows * TILE_SIZE);
+    bitmap.fill(BLACK);
+    drawArea(bitmap, tiles, *map, startArea(*map, maxRows, maxCols));
+    bitmap.enlarge();
+    writePng(bitmap, filename);
+}
 
-    const int rows = std::min(maxRows, map->hei());
-    const int cols = std::min(maxCols, map->len());
-
-    CStates & states = map->states();
-    const uint16_t startPos = states.getU(POS_ORIGIN);
+/**
+ * @brief Write a screenshot of each map, and optionally a contact sheet.
+ *        The tiles are loaded once; the maps are rendered, compressed and
+ *        written on a pool of threads, one map at a time per worker, so
+ *        the compression of a map overlaps the rendering of the next.
+ *
+ * @param maps
+ * @param folder written to folder/levelNN.png and folder/atlas.png
+ * @param options
+ * @return int screenshots written
+ */
+int exportScreenshots(const std::vector<CMap *> &maps, const QString &folder, const screenshotOptions_t &options)
+{
+    CFrameSet tiles;
+    if (maps.empty() || !loadTiles(tiles)) {
+        return 0;
+    }
 
-    const Pos pos = startPos !=0 ? CMap::toPos(startPos): map->findFirst(TILES_ANNIE2);
-    const bool isFound = pos.x != CMap::NOT_FOUND || pos.y != CMap::NOT_FOUND;
-    const int lmx = std::max(0, isFound? pos.x - cols / 2 : 0);
-    const int lmy = std::max(0, isFound? pos.y - rows / 2 : 0);
-    const int mx = std::min(lmx, map->len() > cols ? map->len() - cols : 0);
-    const int my = std::min(lmy, map->hei() > rows ? map->hei() - rows : 0);
+    // contact sheet: one thumbnail of each start area, as large as fits
+    const size_t count = maps.size();
+    const int atlasCols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const int atlasRows = static_cast<int>((count + atlasCols - 1) / atlasCols);
+    int thumbSize = 4;
+    while (thumbSize > 1 && std::max(atlasCols * (options.maxCols * thumbSize + ATLAS_GAP),
+                                     atlasRows * (options.maxRows * thumbSize + ATLAS_GAP)) > MAX_FRAME_SIZE) {
+        thumbSize /= 2;
+    }
+    const int cellWidth = options.maxCols * thumbSize + ATLAS_GAP;
+    const int cellHeight = options.maxRows * thumbSize + ATLAS_GAP;
+    CTileMips mips;
+    CFrame atlas;
+    if (options.atlas) {
+        mips.build(tiles);
+        CFrame frame(std::min(atlasCols * cellWidth, MAX_FRAME_SIZE), std::min(atlasRows * cellHeight, MAX_FRAME_SIZE));
+        swap(atlas, frame);
+        atlas.fill(BLACK);
+    }
 
-    const int tileSize = 16;
-    const int lineSize = maxCols * tileSize;
-    CFrame bitmap(maxCols * tileSize, maxRows *tileSize);
-    bitmap.fill(BLACK);
-    uint32_t *rgba = bitmap.getRGB().data();
-    for (int row=0; row < rows; ++row) {
-        for (int col=0; col < cols; ++col) {
-            uint8_t tile = map->at(col + mx, row +my);
-            CFrame *frame = (*fs)[tile];
-            for (int y=0; y < tileSize; ++y) {
-                for (int x=0; x < tileSize; ++x) {
-                    rgba[x + col*tileSize+ y * lineSize + row * tileSize*lineSize] = frame->at(x,y) | ALPHA;
+    unsigned jobs = options.jobs ? options.jobs : std::thread::hardware_concurrency();
+    jobs = std::max(1u, std::min<unsigned>(jobs, count));
+    std::atomic<size_t> next{0};
+    std::atomic<int> written{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            CMap &map = *maps[i];
+            const area_t area = startArea(map, options.maxRows, options.maxCols);
+            if (options.atlas) {
+                // each thumbnail has its own cell: no two workers write the same pixels
+                const int x = static_cast<int>(i % atlasCols) * cellWidth + ATLAS_GAP / 2;
+                const int y = static_cast<int>(i / atlasCols) * cellHeight + ATLAS_GAP / 2;
+                if (x + options.maxCols * thumbSize <= atlas.width() && y + options.maxRows * thumbSize <= atlas.height()) {
+                    drawThumb(atlas.getRGB().data() + x + y * atlas.width(), atlas.width(), mips, map, area, thumbSize);
                 }
             }
+
+            // whole maps at 16 pixels per tile; start areas at twice that
+            const area_t whole{0, 0, std::min(map.len(), MAX_FRAME_SIZE / TILE_SIZE), std::min(map.hei(), MAX_FRAME_SIZE / TILE_SIZE)};
+            const int cols = options.wholeMap ? whole.cols : options.maxCols;
+            const int rows = options.wholeMap ? whole.rows : options.maxRows;
+            if (cols <= 0 || rows <= 0) {
+                continue;
+            }
+            CFrame bitmap(cols * TILE_SIZE, rows * TILE_SIZE);
+            bitmap.fill(BLACK);
+            drawArea(bitmap, tiles, map, options.wholeMap ? whole : area);
+            if (!options.wholeMap) {
+                bitmap.enlarge();
+            }
+            const QString filename = folder + QString("/level%1.png").arg(i + 1, 2, 10, QLatin1Char('0'));
+            // the maps already keep every core busy: one deflate stream each
+            if (writePng(bitmap, filename, jobs > 1 ? 1 : 0)) {
+                ++written;
+            }
         }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < jobs; ++i) {
+        workers.emplace_back(worker);
     }
-    bitmap.enlarge();
-    //uint8_t *png;
-    //int size;
-    std::vector<uint8_t> png;
-    bitmap.toPng(png);
-    if (file.open(filename.toStdString().c_str(), "wb")) {
-        file.write(png.data(), png.size());
-        file.close();
+    worker();
+    for (auto &thread : workers) {
+        thread.join();
     }
 
-    delete fs;
+    if (options.atlas) {
+        writePng(atlas, folder + "/atlas.png");
+    }
+    return written;
 }
@@ -1,8 +1,21 @@
 #pragma once
 
+#include <vector>
+
 class CMapFile;
 class QString;
 class CMap;
 
 bool generateReport(CMapFile & mf, const QString & filename);
 void generateScreenshot(const QString &filename, CMap *map, const int maxRow=16, const int maxCols=16);
+
+struct screenshotOptions_t
+{
+    int maxRows = 24;
+    int maxCols = 24;
+    bool wholeMap = false; // the whole map at 16 pixels per tile, rather than the start area
+    bool atlas = false;    // and a contact sheet of every map
+    unsigned jobs = 0;     // 0 for all cores
+};
+
+int exportScreenshots(const std::vector<CMap *> &maps, const QString &folder, const screenshotOptions_t &options);
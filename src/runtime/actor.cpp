@@ -145,16 +145,17 @@ CActor::~CActor()
 /**
  * @brief Can Sprite Move in given direction
  *
+ * @param game session owning the map
  * @param aim
  * @return true
  * @return false
  */
 
-bool CActor::canMove(const JoyAim aim) const
+bool CActor::canMove(const CGame &game, const JoyAim aim) const
 {
-    const CMap &map = CGame::getMap();
+    const CMap &map = game.map();
     const Pos &pos = Pos{m_x, m_y};
-    const Pos &newPos = CGame::translate(pos, aim);
+    const Pos &newPos = game.translate(pos, aim);
     if (pos.x == newPos.x && pos.y == newPos.y)
     {
         return false;
@@ -180,7 +181,7 @@ bool CActor::canMove(const JoyAim aim) const
         }
         else if (def.type == TYPE_DOOR)
         {
-            return CGame::hasKey(c + 1);
+            return game.hasKey(c + 1);
         }
     }
     else if (RANGE(m_type, ATTR_CRUSHER_MIN, ATTR_CRUSHER_MAX))
@@ -199,16 +200,17 @@ bool CActor::canMove(const JoyAim aim) const
 /**
  * @brief Move Sprite in given Direction
  *
+ * @param game session owning the map
  * @param aim
  */
 
-void CActor::move(const JoyAim aim)
+void CActor::move(CGame &game, const JoyAim aim)
 {
-    CMap &map = CGame::getMap();
+    CMap &map = game.map();
     const uint8_t c = map.at(m_x, m_y);
     map.set(m_x, m_y, m_pu);
 
-    const Pos pos = CGame::translate(Pos{m_x, m_y}, aim);
+    const Pos pos = game.translate(Pos{m_x, m_y}, aim);
     m_x = pos.x;
     m_y = pos.y;
 
@@ -254,10 +256,11 @@ void CActor::setPos(const Pos &pos)
 /**
  * @brief Find Next Director (monsters)
  *
+ * @param game session owning the map
  * @param reverse, flip search order
  * @return JoyAim
  */
-JoyAim CActor::findNextDir(const bool reverse) const
+JoyAim CActor::findNextDir(const CGame &game, const bool reverse) const
 {
     const int aim = m_aim;
     int i = TOTAL_AIMS - 1;
@@ -269,7 +272,7 @@ JoyAim CActor::findNextDir(const bool reverse) const
         {
             newAim = ::reverseDir(newAim);
         }
-        if (canMove(newAim))
+        if (canMove(game, newAim))
         {
             return newAim;
         }
@@ -301,14 +304,15 @@ void CActor::setAim(const JoyAim aim)
 /**
  * @brief Is Player present at given relative postion
  *
+ * @param game session owning the map
  * @param aim
  * @return true
  * @return false
  */
 
-bool CActor::isPlayerThere(JoyAim aim) const
+bool CActor::isPlayerThere(const CGame &game, JoyAim aim) const
 {
-    const uint8_t c = tileAt(aim);
+    const uint8_t c = tileAt(game, aim);
     const TileDef &def = getTileDef(c);
     return def.type == TYPE_PLAYER;
 }
@@ -316,13 +320,14 @@ bool CActor::isPlayerThere(JoyAim aim) const
 /**
  * @brief Get tileID at give relative position
  *
+ * @param game session owning the map
  * @param aim
  * @return uint8_t
  */
-uint8_t CActor::tileAt(JoyAim aim) const
+uint8_t CActor::tileAt(const CGame &game, JoyAim aim) const
 {
-    const CMap &map = CGame::getMap();
-    const Pos &p = CGame::translate(Pos{m_x, m_y}, aim);
+    const CMap &map = game.map();
+    const Pos &p = game.translate(Pos{m_x, m_y}, aim);
     return map.at(p.x, p.y);
 }
 
@@ -538,7 +543,7 @@ void CActor::move(const Pos pos)
     move(pos.x, pos.y);
 }
 
-CPath::Result CActor::followPath(const Pos &playerPos)
+CPath::Result CActor::followPath(CGame &game, const Pos &playerPos)
 {
     auto pathAlgo = CPath::getPathAlgo(m_algo);
     if (!pathAlgo)
@@ -546,7 +551,7 @@ CPath::Result CActor::followPath(const Pos &playerPos)
     if (m_path)
     {
         decTTL();
-        auto result = m_path->followPath(*this, playerPos, *pathAlgo);
+        auto result = m_path->followPath(game, *this, playerPos, *pathAlgo);
         if (m_ttl == 0 && CGame::isBulletType(m_type))
             m_path.reset(); // replaces delete + nullptr
 
@@ -560,7 +565,7 @@ bool CActor::isFollowingPath()
     return m_path != nullptr;
 }
 
-bool CActor::startPath(const Pos &playerPos, const uint8_t algo, const int ttl)
+bool CActor::startPath(CGame &game, const Pos &playerPos, const uint8_t algo, const int ttl)
 {
     m_algo = algo;
     auto pathAlgo = CPath::getPathAlgo(algo);
@@ -569,5 +574,5 @@ bool CActor::startPath(const Pos &playerPos, const uint8_t algo, const int ttl)
     if (!m_path)
         m_path = std::make_unique<CPath>();
     m_ttl = ttl;
-    return m_path->followPath(*this, playerPos, *pathAlgo);
+    return m_path->followPath(game, *this, playerPos, *pathAlgo);
 }
\ No newline at end of file
@@ -46,8 +46,8 @@ public:
 
     ~CActor();
 
-    bool canMove(const JoyAim aim) const override;
-    void move(const JoyAim aim) override;
+    bool canMove(const CGame &game, const JoyAim aim) const override;
+    void move(CGame &game, const JoyAim aim) override;
     inline int16_t x() const override
     {
         return static_cast<int16_t>(m_x);
@@ -65,9 +65,9 @@ public:
     void setPos(const Pos &pos);
     JoyAim getAim() const override;
     void setAim(const JoyAim aim) override;
-    JoyAim findNextDir(const bool reverse = false) const;
-    bool isPlayerThere(JoyAim aim) const;
-    uint8_t tileAt(JoyAim aim) const;
+    JoyAim findNextDir(const CGame &game, const bool reverse = false) const;
+    bool isPlayerThere(const CGame &game, JoyAim aim) const;
+    uint8_t tileAt(const CGame &game, JoyAim aim) const;
     void setType(const uint8_t type);
     bool isWithin(const int x1, const int y1, const int x2, const int y2) const;
     bool read(IFile &file);
@@ -78,8 +78,8 @@ public:
     void move(const int16_t x, const int16_t y) override;
     void move(const Pos pos) override;
     inline int16_t getGranularFactor() const override { return ACTOR_GRANULAR_FACTOR; };
-    CPath::Result followPath(const Pos &playerPos);
-    bool startPath(const Pos &playerPos, const uint8_t algo, const int timeout);
+    CPath::Result followPath(CGame &game, const Pos &playerPos);
+    bool startPath(CGame &game, const Pos &playerPos, const uint8_t algo, const int timeout);
     bool isFollowingPath();
     bool isBoss() const override { return false; }
     const CPath *path() const { return m_path.get(); };
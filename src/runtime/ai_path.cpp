@@ -85,10 +85,10 @@ int AStar::manhattanDistance(const Pos &a, const Pos &b) const
     return abs(a.x - b.x) + abs(a.y - b.y);
 }
 
-std::vector<JoyAim> AStar::findPath(ISprite &sprite, const Pos &goalPos) const
+std::vector<JoyAim> AStar::findPath(const CGame &game, ISprite &sprite, const Pos &goalPos) const
 {
     const int granularFactor = sprite.getGranularFactor();
-    const CMap &map = CGame::getMap();
+    const CMap &map = game.map();
     const int mapLen = map.len() * granularFactor;
     const int mapHei = map.hei() * granularFactor;
     std::vector<JoyAim> directions;
@@ -106,6 +106,7 @@ std::vector<JoyAim> AStar::findPath(ISprite &sprite, const Pos &goalPos) const
     // Priority queue for open list
     std::priority_queue<Node *, std::vector<Node *>, CompareNode> openList;
     std::unordered_map<Pos, std::unique_ptr<Node>> nodes;
+    std::vector<std::unique_ptr<Node>> replaced;
     std::unordered_map<Pos, bool> closedList;
 
     // Create start node
@@ -173,7 +174,7 @@ std::vector<JoyAim> AStar::findPath(ISprite &sprite, const Pos &goalPos) const
 
             // Check if move is valid
             sprite.move(newPos);
-            if (!sprite.canMove(g_dirs[i]))
+            if (!sprite.canMove(game, g_dirs[i]))
             {
                 sprite.move(originalPos);
                 continue;
@@ -186,6 +187,9 @@ std::vector<JoyAim> AStar::findPath(ISprite &sprite, const Pos &goalPos) const
             auto it = nodes.find(newPos);
             if (it == nodes.end() || newGCost < it->second->gCost)
             {
+                // the open list and the children may still point to the old node
+                if (it != nodes.end())
+                    replaced.emplace_back(std::move(it->second));
                 nodes[newPos] = std::make_unique<Node>(newPos, newGCost, newHCost, current);
                 openList.push(nodes[newPos].get());
             }
@@ -195,10 +199,10 @@ std::vector<JoyAim> AStar::findPath(ISprite &sprite, const Pos &goalPos) const
     return directions; // Empty if no path found
 }
 
-std::vector<JoyAim> BFS::findPath(ISprite &sprite, const Pos &goalPos) const
+std::vector<JoyAim> BFS::findPath(const CGame &game, ISprite &sprite, const Pos &goalPos) const
 {
     const int granularFactor = sprite.getGranularFactor();
-    const CMap &map = CGame::getMap();
+    const CMap &map = game.map();
     const int mapLen = map.len() * granularFactor;
     const int mapHei = map.hei() * granularFactor;
     const Pos startPos = sprite.pos();
@@ -265,7 +269,7 @@ std::vector<JoyAim> BFS::findPath(ISprite &sprite, const Pos &goalPos) const
 
             Pos originalPos = sprite.pos();
             sprite.move(newPos);
-            if (sprite.canMove(g_dirs[i]))
+            if (sprite.canMove(game, g_dirs[i]))
             {
                 queue.push(newPos);
                 visited[newPos] = true;
@@ -277,10 +281,10 @@ std::vector<JoyAim> BFS::findPath(ISprite &sprite, const Pos &goalPos) const
     return {};
 }
 
-std::vector<JoyAim> LineOfSight::findPath(ISprite &sprite, const Pos &playerPos) const
+std::vector<JoyAim> LineOfSight::findPath(const CGame &game, ISprite &sprite, const Pos &playerPos) const
 {
     int granularFactor = sprite.getGranularFactor();
-    const CMap &map = CGame::getMap();
+    const CMap &map = game.map();
     const int mapLen = map.len() * granularFactor; // Half-tile bounds
     const int mapHei = map.hei() * granularFactor;
     const Pos startPos = sprite.pos(); // Half-tile coordinates
@@ -317,7 +321,7 @@ std::vector<JoyAim> LineOfSight::findPath(ISprite &sprite, const Pos &playerPos)
             {
                 sprite.move(next);
                 JoyAim aim = (stepX > 0 ? AIM_RIGHT : AIM_LEFT);
-                if (sprite.canMove(aim))
+                if (sprite.canMove(game, aim))
                 {
                     directions.push_back(aim);
                     x += stepX;
@@ -335,7 +339,7 @@ std::vector<JoyAim> LineOfSight::findPath(ISprite &sprite, const Pos &playerPos)
             {
                 const_cast<ISprite &>(sprite).move(next);
                 JoyAim aim = (stepY > 0 ? AIM_DOWN : AIM_UP);
-                if (sprite.canMove(aim))
+                if (sprite.canMove(game, aim))
                 {
                     directions.push_back(aim);
                     y += stepY;
@@ -363,12 +367,12 @@ int AStarSmooth::manhattanDistance(const Pos &a, const Pos &b) const
     return abs(a.x - b.x) + abs(a.y - b.y);
 }
 
-std::vector<JoyAim> AStarSmooth::smoothPath(const std::vector<Pos> &path, ISprite &sprite) const
+std::vector<JoyAim> AStarSmooth::smoothPath(const CGame &game, const std::vector<Pos> &path, ISprite &sprite) const
 {
     if (path.size() < 2)
         return {};
     const int granularFactor = sprite.getGranularFactor();
-    const CMap &map = CGame::getMap();
+    const CMap &map = game.map();
     const int mapLen = map.len() * granularFactor; // Half-tile bounds
     const int mapHei = map.hei() * granularFactor;
     std::vector<Pos> smoothedPath = {path[0]};
@@ -389,7 +393,7 @@ std::vector<JoyAim> AStarSmooth::smoothPath(const std::vector<Pos> &path, ISprit
                 break;
             }
             // Reuse LineOfSight to check if direct path is clear in half-tile space
-            if (!los.findPath(const_cast<ISprite &>(sprite), end).empty())
+            if (!los.findPath(game, const_cast<ISprite &>(sprite), end).empty())
             {
                 j++;
             }
@@ -425,10 +429,10 @@ std::vector<JoyAim> AStarSmooth::smoothPath(const std::vector<Pos> &path, ISprit
     return directions;
 }
 
-std::vector<JoyAim> AStarSmooth::findPath(ISprite &sprite, const Pos &playerPos) const
+std::vector<JoyAim> AStarSmooth::findPath(const CGame &game, ISprite &sprite, const Pos &playerPos) const
 {
     const int granularFactor = sprite.getGranularFactor();
-    const CMap &map = CGame::getMap();
+    const CMap &map = game.map();
     const int mapLen = map.len() * granularFactor; // Half-tile bounds
     const int mapHei = map.hei() * granularFactor;
     const Pos startPos = sprite.pos(); // Half-tile coordinates
@@ -464,7 +468,7 @@ std::vector<JoyAim> AStarSmooth::findPath(ISprite &sprite, const Pos &playerPos)
                 node = node->parent;
             }
             std::reverse(path.begin(), path.end());
-            return smoothPath(path, sprite); // Apply smoothing
+            return smoothPath(game, path, sprite); // Apply smoothing
         }
 
         closedList[current->pos] = true;
@@ -477,7 +481,7 @@ std::vector<JoyAim> AStarSmooth::findPath(ISprite &sprite, const Pos &playerPos)
 
             const Pos originalPos = sprite.pos();
             const_cast<ISprite &>(sprite).move(newPos);
-            if (!sprite.canMove(g_dirs[i]))
+            if (!sprite.canMove(game, g_dirs[i]))
             {
                 sprite.move(originalPos);
                 continue;
@@ -496,7 +500,7 @@ std::vector<JoyAim> AStarSmooth::findPath(ISprite &sprite, const Pos &playerPos)
 }
 
 ////////////////////////////////////////////////
-CPath::Result CPath::followPath(ISprite &sprite, const Pos &playerPos, const IPath &astar)
+CPath::Result CPath::followPath(CGame &game, ISprite &sprite, const Pos &playerPos, const IPath &astar)
 {
     //if (!sprite.isBoss())
         //LOGI("sprite: %p[%d,%d] aim:%d p[%d,%d] ptr=%lu timeout=%lu cache:%lu ttl:%d",
@@ -507,7 +511,7 @@ CPath::Result CPath::followPath(ISprite &sprite, const Pos &playerPos, const IPa
     // Check if path is invalid or timed out
     if (m_pathIndex >= m_cachedDirections.size() || m_pathTimeout <= 0)
     {
-        m_cachedDirections = astar.findPath(sprite, playerPos);
+        m_cachedDirections = astar.findPath(game, sprite, playerPos);
         m_pathIndex = 0;
         if (!m_pathTimeout)
             m_pathTimeout = PATH_TIMEOUT_MAX;
@@ -522,15 +526,15 @@ CPath::Result CPath::followPath(ISprite &sprite, const Pos &playerPos, const IPa
     // Try the next direction
     const JoyAim aim = m_cachedDirections[m_pathIndex];
     sprite.setAim(aim);
-    if (sprite.canMove(aim))
+    if (sprite.canMove(game, aim))
     {
         if (sprite.isBoss())
         {
-            sprite.move(aim);
+            sprite.move(game, aim);
         }
         else
         {
-            CGame::getGame()->shadowActorMove(*static_cast<CActor *>(&sprite), aim);
+            game.shadowActorMove(*static_cast<CActor *>(&sprite), aim);
         }
         ++m_pathIndex;
         --m_pathTimeout;
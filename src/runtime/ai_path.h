@@ -24,19 +24,20 @@
 #include "map.h"
 
 class ISprite;
+class CGame;
 class IFile;
 
 class IPath
 {
 public:
-    virtual std::vector<JoyAim> findPath(ISprite &sprite, const Pos &playerPos) const = 0;
+    virtual std::vector<JoyAim> findPath(const CGame &game, ISprite &sprite, const Pos &playerPos) const = 0;
 };
 
 // A* Pathfinding class
 class AStar : public IPath
 {
 public:
-    std::vector<JoyAim> findPath(ISprite &sprite, const Pos &playerPos) const override;
+    std::vector<JoyAim> findPath(const CGame &game, ISprite &sprite, const Pos &playerPos) const override;
 
 private:
     int manhattanDistance(const Pos &a, const Pos &b) const;
@@ -46,25 +47,25 @@ private:
 class AStarSmooth : public IPath
 {
 public:
-    std::vector<JoyAim> findPath(ISprite &sprite, const Pos &playerPos) const override;
+    std::vector<JoyAim> findPath(const CGame &game, ISprite &sprite, const Pos &playerPos) const override;
 
 private:
     int manhattanDistance(const Pos &a, const Pos &b) const;
-    std::vector<JoyAim> smoothPath(const std::vector<Pos> &path, ISprite &sprite) const;
+    std::vector<JoyAim> smoothPath(const CGame &game, const std::vector<Pos> &path, ISprite &sprite) const;
 };
 
 // BFS Pathfinding class
 class BFS : public IPath
 {
 public:
-    std::vector<JoyAim> findPath(ISprite &sprite, const Pos &playerPos) const override;
+    std::vector<JoyAim> findPath(const CGame &game, ISprite &sprite, const Pos &playerPos) const override;
 };
 
 // Line-of-Sight Pathfinding class
 class LineOfSight : public IPath
 {
 public:
-    std::vector<JoyAim> findPath(ISprite &sprite, const Pos &playerPos) const override;
+    std::vector<JoyAim> findPath(const CGame &game, ISprite &sprite, const Pos &playerPos) const override;
 };
 
 class CPath
@@ -81,7 +82,7 @@ public:
         NotConfigured
     };
 
-    Result followPath(ISprite &sprite, const Pos &playerPos, const IPath &astar);
+    Result followPath(CGame &game, ISprite &sprite, const Pos &playerPos, const IPath &astar);
     bool read(IFile &file);
     bool write(IFile &file);
     void setTimeout(int timeout);
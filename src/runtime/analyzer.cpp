@@ -0,0 +1,509 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "analyzer.h"
+#include "maparch.h"
+#include "states.h"
+#include "statedata.h"
+#include "statehash.h"
+#include "tilesdata.h"
+#include "tilesdefs.h"
+#include "sprtypes.h"
+
+namespace AnalyzerPrivate
+{
+    constexpr JoyAim AIMS[] = {AIM_UP, AIM_DOWN, AIM_LEFT, AIM_RIGHT};
+    constexpr uint8_t NO_KEY = 0xff;
+    constexpr uint32_t ICE_BIT = 1; // blocks are stored as (cell << 1) | ice
+
+    // std::popcount is C++20; the editor is built as C++17
+    inline uint32_t bitCount(uint64_t v)
+    {
+        v = v - ((v >> 1) & 0x5555555555555555ull);
+        v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+        v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return static_cast<uint32_t>((v * 0x0101010101010101ull) >> 56);
+    }
+};
+
+using namespace AnalyzerPrivate;
+
+size_t CLevelAnalyzer::layoutHash_t::operator()(const std::vector<uint32_t> &blocks) const
+{
+    uint64_t h = blocks.size();
+    for (const uint32_t block : blocks)
+        h = StateHash::mix(h ^ block);
+    return static_cast<size_t>(h);
+}
+
+CLevelAnalyzer::CLevelAnalyzer(const CMap &map) : m_len(map.len()), m_hei(map.hei()), m_stride(map.len() + 2)
+{
+    scan(map);
+}
+
+/**
+ * @brief Classify every cell once, so that the search never looks at tiles
+ *
+ * @param map
+ */
+void CLevelAnalyzer::scan(const CMap &map)
+{
+    // a wall all around spares the bound checks
+    const size_t size = static_cast<size_t>(m_stride) * (m_hei + 2);
+    if (m_len == 0 || m_hei == 0 || size > (size_t(1) << MAX_CELL_BITS))
+    {
+        m_len = m_hei = 0;
+        return;
+    }
+    m_cells.assign(size, CELL_WALL);
+    m_keyBits.assign(size, NO_KEY);
+    m_diamondIds.assign(size, NONE);
+    m_seen.assign(size, 0);
+    m_blocked.assign(size, 0);
+    m_offsets[AIM_UP] = -m_stride;
+    m_offsets[AIM_DOWN] = m_stride;
+    m_offsets[AIM_LEFT] = -1;
+    m_offsets[AIM_RIGHT] = 1;
+
+    std::vector<uint8_t> keyTiles;
+    std::vector<uint32_t> blocks;
+    for (int y = 0; y < m_hei; ++y)
+    {
+        for (int x = 0; x < m_len; ++x)
+        {
+            const uint32_t cell = toCell(x, y);
+            const uint8_t c = map.at(x, y);
+            const TileDef &def = getTileDef(c);
+            switch (def.type)
+            {
+            case TYPE_BACKGROUND:
+            case TYPE_STOP:
+            case TYPE_MONSTER:
+            case TYPE_DRONE:
+                m_cells[cell] = CELL_OPEN;
+                break;
+            case TYPE_PLAYER:
+                m_cells[cell] = CELL_OPEN;
+                if (m_origin == NONE)
+                    m_origin = cell;
+                break;
+            case TYPE_PICKUP:
+            case TYPE_SWAMP:
+            case TYPE_FIRE:
+                m_cells[cell] = CELL_FLOOR;
+                break;
+            case TYPE_DIAMOND:
+                m_cells[cell] = CELL_FLOOR;
+                m_diamondIds[cell] = m_diamonds.size();
+                m_diamonds.emplace_back(Pos{static_cast<int16_t>(x), static_cast<int16_t>(y)});
+                break;
+            case TYPE_KEY:
+            {
+                m_cells[cell] = CELL_FLOOR;
+                auto it = std::find(keyTiles.begin(), keyTiles.end(), c);
+                if (it == keyTiles.end())
+                    it = keyTiles.insert(keyTiles.end(), c);
+                const size_t bit = it - keyTiles.begin();
+                if (bit < MAX_KEY_BITS)
+                    m_keyBits[cell] = bit;
+                m_keys.emplace_back(cell);
+                break;
+            }
+            case TYPE_DOOR:
+                m_cells[cell] = CELL_DOOR;
+                break;
+            case TYPE_CHUTE:
+                m_cells[cell] = CELL_CHUTE;
+                break;
+            case TYPE_BOULDER:
+            case TYPE_ICECUBE:
+                m_cells[cell] = CELL_OPEN;
+                blocks.emplace_back((cell << 1) | (def.type == TYPE_ICECUBE ? ICE_BIT : 0));
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    // doors open with the key tile that follows them
+    m_keyHasDoor.assign(keyTiles.size(), false);
+    for (uint32_t cell = 0; cell < size; ++cell)
+    {
+        if (m_cells[cell] != CELL_DOOR)
+            continue;
+        const Pos pos = toPos(cell);
+        const uint8_t key = map.at(pos.x, pos.y) + 1;
+        auto it = std::find(keyTiles.begin(), keyTiles.end(), key);
+        if (it == keyTiles.end())
+            continue; // never opens
+        const size_t bit = it - keyTiles.begin();
+        m_keyHasDoor[bit] = true;
+        if (bit < MAX_KEY_BITS)
+            m_keyBits[cell] = bit;
+        else
+            m_cells[cell] = CELL_FLOOR; // too many keys: assume it opens
+    }
+
+    const CStates &states = map.statesConst();
+    const uint16_t origin = states.getU(POS_ORIGIN);
+    if (origin != 0)
+    {
+        const Pos pos = CMap::toPos(origin);
+        if (map.isValid(pos.x, pos.y))
+            m_origin = toCell(pos.x, pos.y);
+    }
+    const uint16_t exitKey = states.getU(POS_EXIT);
+    if (exitKey != 0)
+    {
+        const Pos pos = CMap::toPos(exitKey);
+        if (map.isValid(pos.x, pos.y))
+            m_exit = toCell(pos.x, pos.y);
+    }
+    m_goal = states.hasU(MAP_GOAL) ? states.getU(MAP_GOAL) : m_diamonds.size();
+
+    m_exitBit = m_diamonds.size();
+    m_chuteBit = m_exitBit + 1;
+    m_words = (m_chuteBit + 64) / 64;
+    std::sort(blocks.begin(), blocks.end());
+    internLayout(std::move(blocks));
+}
+
+/**
+ * @brief Explore the level from the player's origin
+ *
+ * @return levelAnalysis_t
+ */
+levelAnalysis_t CLevelAnalyzer::run()
+{
+    levelAnalysis_t result;
+    if (m_len == 0 || m_origin == NONE)
+    {
+        result.truncated = m_len == 0;
+        result.unreachableDiamonds = m_diamonds;
+        for (const uint32_t cell : m_keys)
+            result.unusedKeys.emplace_back(toPos(cell));
+        return result;
+    }
+
+    bool truncated = false;
+    addState(NONE, m_origin, 0, 0, softlock_t{{0, 0}, AIM_NONE}, truncated);
+    for (uint32_t id = 0; id < m_states.size() && !truncated; ++id)
+        expand(id, truncated);
+    const uint32_t count = m_states.size();
+    result.states = count;
+    result.truncated = truncated;
+
+    // what can still be reached from each state: its area and everything
+    // reachable from its successors. Edges mostly point forward.
+    std::vector<uint64_t> reach(m_area);
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        for (auto it = m_edges.rbegin(); it != m_edges.rend(); ++it)
+        {
+            uint64_t *from = &reach[it->from * m_words];
+            const uint64_t *to = &reach[it->to * m_words];
+            for (size_t i = 0; i < m_words; ++i)
+            {
+                const uint64_t bits = from[i] | to[i];
+                changed |= bits != from[i];
+                from[i] = bits;
+            }
+        }
+    }
+
+    const uint64_t *all = &reach[0];
+    for (size_t i = 0; i < m_diamonds.size(); ++i)
+    {
+        if (!test(all, i))
+            result.unreachableDiamonds.emplace_back(m_diamonds[i]);
+    }
+    result.chute = test(all, m_chuteBit);
+
+    uint8_t heldKeys = 0;
+    for (const state_t &state : m_states)
+        heldKeys |= state.keys;
+    for (const uint32_t cell : m_keys)
+    {
+        const uint8_t bit = m_keyBits[cell];
+        const bool held = bit == NO_KEY || (heldKeys & (1 << bit));
+        const bool hasDoor = bit == NO_KEY || m_keyHasDoor[bit];
+        if (!held || !hasDoor)
+            result.unusedKeys.emplace_back(toPos(cell));
+    }
+
+    // a level can be won from a state when the diamonds picked up on the
+    // way there meet the goal and the exit is still ahead
+    std::vector<bool> dead(count, false);
+    for (uint32_t id = 0; id < count; ++id)
+    {
+        const uint64_t *ahead = &reach[id * m_words];
+        const bool exitOk = m_exit == NONE || test(ahead, m_exitBit);
+        dead[id] = !exitOk || popCount(ahead) < m_goal;
+        if (exitOk && popCount(collectedOf(id)) >= m_goal)
+            result.solvable = true;
+    }
+
+    // a push is a softlock when it leaves too few diamonds in reach, unless
+    // they were collected beforehand. Only meaningful in a level that can be
+    // won, once every state has been explored.
+    if (result.solvable && !truncated)
+    {
+        for (const edge_t &edge : m_edges)
+        {
+            if (dead[edge.from] || !dead[edge.to])
+                continue;
+            const softlock_t &push = edge.push;
+            const bool known = std::any_of(result.softlocks.begin(), result.softlocks.end(), [&push](const softlock_t &s)
+                                           { return s.block == push.block && s.aim == push.aim; });
+            if (!known)
+                result.softlocks.emplace_back(push);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Analyze every level of an archive, one level per worker
+ *
+ * @param arch
+ * @param jobs worker count, 0 for all cores
+ * @return std::vector<levelAnalysis_t> one entry per level
+ */
+std::vector<levelAnalysis_t> CLevelAnalyzer::runAll(CMapArch &arch, unsigned jobs)
+{
+    const uint32_t count = arch.size();
+    std::vector<levelAnalysis_t> results(count);
+    if (jobs == 0)
+        jobs = std::thread::hardware_concurrency();
+    jobs = std::max(1u, std::min<unsigned>(jobs, count));
+
+    std::atomic<uint32_t> next{0};
+    auto worker = [&arch, &results, &next, count]()
+    {
+        for (uint32_t i = next++; i < count; i = next++)
+            results[i] = CLevelAnalyzer(*arch.at(i)).run();
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < jobs; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &thread : workers)
+        thread.join();
+    return results;
+}
+
+uint32_t CLevelAnalyzer::internLayout(std::vector<uint32_t> &&blocks)
+{
+    auto it = m_layoutIds.find(blocks);
+    if (it != m_layoutIds.end())
+        return it->second;
+    const uint32_t id = m_layouts.size();
+    m_layoutIds.emplace(blocks, id);
+    m_layouts.emplace_back(std::move(blocks));
+    return id;
+}
+
+/**
+ * @brief Find or create the state of a player standing on a given cell
+ *
+ * @param parent state the player comes from, NONE for the first one
+ * @param cell
+ * @param keys keys held
+ * @param layout
+ * @param push push that led here
+ * @param truncated set when the state budget is exhausted
+ * @return uint32_t state id, NONE if it couldn't be added
+ */
+uint32_t CLevelAnalyzer::addState(const uint32_t parent, const uint32_t cell, const uint8_t keys, const uint32_t layout, const softlock_t &push, bool &truncated)
+{
+    if (m_work >= MAX_WORK)
+    {
+        truncated = true;
+        return NONE;
+    }
+    uint32_t anchor;
+    const uint8_t held = flood(cell, keys, layout, anchor);
+    const uint64_t packed = (static_cast<uint64_t>(layout) << 32) |
+                            (static_cast<uint64_t>(held) << MAX_CELL_BITS) |
+                            anchor;
+    auto it = m_stateIds.find(packed);
+    if (it != m_stateIds.end())
+    {
+        if (parent != NONE)
+            m_edges.emplace_back(edge_t{parent, it->second, push});
+        return it->second;
+    }
+    if (m_states.size() >= MAX_STATES)
+    {
+        truncated = true;
+        return NONE;
+    }
+
+    const uint32_t id = m_states.size();
+    m_states.emplace_back(state_t{packed, parent, layout, cell, held});
+    m_stateIds.emplace(packed, id);
+    m_area.resize(m_area.size() + m_words, 0);
+    m_collected.resize(m_collected.size() + m_words, 0);
+    uint64_t *area = areaOf(id);
+    for (const uint32_t reached : m_queue)
+    {
+        if (m_diamondIds[reached] != NONE)
+            mark(area, m_diamondIds[reached]);
+        if (reached == m_exit)
+            mark(area, m_exitBit);
+        if (m_cells[reached] == CELL_CHUTE)
+            mark(area, m_chuteBit);
+    }
+    uint64_t *collected = collectedOf(id);
+    for (size_t i = 0; i < m_words; ++i)
+        collected[i] = area[i] | (parent != NONE ? collectedOf(parent)[i] : 0);
+    if (parent != NONE)
+        m_edges.emplace_back(edge_t{parent, id, push});
+    return id;
+}
+
+/**
+ * @brief Flood the area the player can walk to, picking up keys as they
+ *        come within reach. Leaves the area in m_queue and the blocks
+ *        stamped in m_blocked.
+ *
+ * @param cell start
+ * @param keys keys held
+ * @param layout block layout
+ * @param anchor receives the first cell of the area
+ * @return uint8_t keys held afterwards
+ */
+uint8_t CLevelAnalyzer::flood(const uint32_t cell, uint8_t keys, const uint32_t layout, uint32_t &anchor)
+{
+    for (;;)
+    {
+        const uint32_t stamp = ++m_stamp;
+        for (const uint32_t block : m_layouts[layout])
+            m_blocked[block >> 1] = stamp;
+        m_queue.clear();
+        m_queue.emplace_back(cell);
+        m_seen[cell] = stamp;
+        anchor = cell;
+        uint8_t found = keys;
+        for (size_t head = 0; head < m_queue.size(); ++head)
+        {
+            const uint32_t current = m_queue[head];
+            anchor = std::min(anchor, current);
+            const uint8_t type = m_cells[current];
+            if (type == CELL_FLOOR && m_keyBits[current] != NO_KEY)
+                found |= 1 << m_keyBits[current];
+            else if (type == CELL_CHUTE)
+                continue; // the level ends there
+            for (const JoyAim aim : AIMS)
+            {
+                const uint32_t next = current + m_offsets[aim];
+                if (m_seen[next] == stamp || m_blocked[next] == stamp)
+                    continue;
+                const uint8_t nextType = m_cells[next];
+                if (nextType == CELL_WALL ||
+                    (nextType == CELL_DOOR && (m_keyBits[next] == NO_KEY || !(keys & (1 << m_keyBits[next])))))
+                    continue;
+                m_seen[next] = stamp;
+                m_queue.emplace_back(next);
+            }
+        }
+        m_work += m_queue.size();
+        if (found == keys)
+            return keys;
+        keys = found;
+    }
+}
+
+/**
+ * @brief Add the states reached by pushing a block from this state's area
+ *
+ * @param id
+ * @param truncated
+ */
+void CLevelAnalyzer::expand(const uint32_t id, bool &truncated)
+{
+    const state_t state = m_states[id];
+    uint32_t anchor;
+    flood(state.cell, state.keys, state.layout, anchor);
+    const uint32_t stamp = m_stamp;
+
+    struct push_t
+    {
+        uint32_t from;
+        uint32_t to;
+        JoyAim aim;
+    };
+    std::vector<push_t> pushes;
+    for (const uint32_t cell : m_queue)
+    {
+        if (m_cells[cell] == CELL_CHUTE)
+            continue;
+        for (const JoyAim aim : AIMS)
+        {
+            const uint32_t from = cell + m_offsets[aim];
+            if (m_blocked[from] != stamp)
+                continue;
+            const uint32_t to = from + m_offsets[aim];
+            if (m_cells[to] != CELL_OPEN || m_blocked[to] == stamp)
+                continue;
+            pushes.emplace_back(push_t{from, to, aim});
+        }
+    }
+
+    for (const push_t &push : pushes)
+    {
+        if (truncated)
+            return;
+        std::vector<uint32_t> blocks = m_layouts[state.layout];
+        auto it = std::lower_bound(blocks.begin(), blocks.end(), push.from << 1);
+        const bool ice = *it & ICE_BIT;
+        uint32_t to = push.to;
+        if (ice)
+        {
+            // ice cubes slide until something stops them
+            for (uint32_t next = to + m_offsets[push.aim];
+                 m_cells[next] == CELL_OPEN &&
+                 !std::binary_search(blocks.begin(), blocks.end(), next << 1) &&
+                 !std::binary_search(blocks.begin(), blocks.end(), (next << 1) | ICE_BIT);
+                 next += m_offsets[push.aim])
+                to = next;
+        }
+        blocks.erase(it);
+        blocks.insert(std::lower_bound(blocks.begin(), blocks.end(), to << 1), (to << 1) | (ice ? ICE_BIT : 0));
+        const uint32_t layout = internLayout(std::move(blocks));
+        addState(id, push.from, state.keys, layout, softlock_t{toPos(push.from), push.aim}, truncated);
+    }
+}
+
+/**
+ * @brief Number of diamonds in a state bitset
+ *
+ * @param bits
+ * @return uint32_t
+ */
+uint32_t CLevelAnalyzer::popCount(const uint64_t *bits) const
+{
+    uint32_t count = 0;
+    for (size_t i = 0; i < m_words; ++i)
+        count += bitCount(bits[i]);
+    return count - test(bits, m_exitBit) - test(bits, m_chuteBit);
+}
@@ -0,0 +1,152 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "map.h"
+#include "joyaim.h"
+
+class CMapArch;
+
+struct softlock_t
+{
+    Pos block; // where the block stood before the push
+    JoyAim aim;
+};
+
+struct levelAnalysis_t
+{
+    bool solvable = false;
+    bool truncated = false; // state budget exhausted: results are partial
+    bool chute = false;     // a chute can be reached
+    uint32_t states = 0;
+    std::vector<Pos> unreachableDiamonds;
+    std::vector<Pos> unusedKeys; // out of reach, or no matching door
+    std::vector<softlock_t> softlocks;
+    bool hasIssues() const { return !solvable || !unreachableDiamonds.empty() || !unusedKeys.empty() || !softlocks.empty(); }
+};
+
+/**
+ * @brief Static reachability check of a level: explores what the player
+ *        can get to, given the keys held and the boulders and ice cubes
+ *        pushed so far. Monsters are assumed to get out of the way.
+ *
+ * A state is the player's reachable area (identified by its first cell),
+ * the keys held and the layout of the pushable blocks, packed in 64 bits.
+ * Keys are picked up as soon as the area reaches them, so only pushes
+ * lead to new states. The number of states and the flooding work are
+ * bounded, so that a whole archive can be checked on every save.
+ */
+class CLevelAnalyzer
+{
+public:
+    explicit CLevelAnalyzer(const CMap &map);
+    ~CLevelAnalyzer() {};
+
+    levelAnalysis_t run();
+    static std::vector<levelAnalysis_t> runAll(CMapArch &arch, unsigned jobs = 0);
+
+    enum : uint32_t
+    {
+        MAX_STATES = 2048,
+        MAX_WORK = 1 << 22, // cells flooded
+        MAX_KEY_BITS = 8,
+        MAX_CELL_BITS = 24,
+    };
+
+private:
+    enum Cell : uint8_t
+    {
+        CELL_WALL,
+        CELL_FLOOR,  // player only
+        CELL_OPEN,   // player and blocks
+        CELL_DOOR,
+        CELL_CHUTE,
+    };
+
+    enum : uint32_t
+    {
+        NONE = 0xffffffff,
+    };
+
+    struct state_t
+    {
+        uint64_t packed;
+        uint32_t parent;
+        uint32_t layout;
+        uint32_t cell; // where the player stands
+        uint8_t keys;
+    };
+
+    struct edge_t
+    {
+        uint32_t from;
+        uint32_t to;
+        softlock_t push;
+    };
+
+    struct layoutHash_t
+    {
+        size_t operator()(const std::vector<uint32_t> &blocks) const;
+    };
+
+    int m_len;
+    int m_hei;
+    int m_stride;
+    int32_t m_offsets[4]; // by JoyAim
+    uint32_t m_exit = NONE;
+    uint32_t m_origin = NONE;
+    uint32_t m_goal = 0;
+    std::vector<uint8_t> m_cells;
+    std::vector<uint8_t> m_keyBits; // door: bit of its key; key: its own bit
+    std::vector<uint32_t> m_diamondIds;
+    std::vector<Pos> m_diamonds;
+    std::vector<uint32_t> m_keys;
+    std::vector<bool> m_keyHasDoor;
+    size_t m_words = 0; // per state bitset: diamonds, exit, chute
+    uint32_t m_exitBit = 0;
+    uint32_t m_chuteBit = 0;
+
+    std::vector<std::vector<uint32_t>> m_layouts;
+    std::unordered_map<std::vector<uint32_t>, uint32_t, layoutHash_t> m_layoutIds;
+    std::vector<state_t> m_states;
+    std::unordered_map<uint64_t, uint32_t> m_stateIds;
+    std::vector<edge_t> m_edges;
+    std::vector<uint64_t> m_area;      // per state: bits found in its area
+    std::vector<uint64_t> m_collected; // per state: bits picked up on the way there
+    std::vector<uint32_t> m_seen;      // flood stamps
+    std::vector<uint32_t> m_blocked;   // block stamps
+    std::vector<uint32_t> m_queue;
+    uint32_t m_stamp = 0;
+    size_t m_work = 0;
+
+    void scan(const CMap &map);
+    uint32_t internLayout(std::vector<uint32_t> &&blocks);
+    uint32_t addState(const uint32_t parent, const uint32_t cell, const uint8_t keys, const uint32_t layout, const softlock_t &push, bool &truncated);
+    uint8_t flood(const uint32_t cell, uint8_t keys, const uint32_t layout, uint32_t &anchor);
+    void expand(const uint32_t id, bool &truncated);
+    uint32_t popCount(const uint64_t *bits) const;
+    inline uint64_t *areaOf(const uint32_t id) { return &m_area[id * m_words]; }
+    inline uint64_t *collectedOf(const uint32_t id) { return &m_collected[id * m_words]; }
+    inline bool test(const uint64_t *bits, const uint32_t bit) const { return bits[bit / 64] & (uint64_t(1) << (bit % 64)); }
+    inline void mark(uint64_t *bits, const uint32_t bit) { bits[bit / 64] |= uint64_t(1) << (bit % 64); }
+    inline uint32_t toCell(const int x, const int y) const { return (x + 1) + (y + 1) * m_stride; }
+    inline Pos toPos(const uint32_t cell) const { return Pos{static_cast<int16_t>(cell % m_stride - 1), static_cast<int16_t>(cell / m_stride - 1)}; }
+};
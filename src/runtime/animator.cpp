@@ -18,6 +18,7 @@
 #include "animator.h"
 #include "tilesdata.h"
 #include "animzdata.h"
+#include "shared/FrameSet.h"
 #include "gamesfx.h"
 #include <cstring>
 #include <vector>
@@ -93,11 +94,47 @@ void CAnimator::animate()
         int32_t &index = m_seqIndex[i];
         m_tileReplacement[seq.srcTile] = seq.startSeq + index;
         index = index < seq.count - 1 ? index + 1 : 0;
+        resolveFrame(seq.srcTile);
         ++i;
     }
     ++m_offset;
 }
 
+/**
+ * @brief Set the frames the tiles resolve to, and resolve them all
+ *
+ * @param tiles one frame per tile
+ * @param animz animation frames
+ * @param hideSpecial resolve blank, stop and special case tiles to nullptr
+ */
+void CAnimator::setFrameSets(CFrameSet *tiles, CFrameSet *animz, const bool hideSpecial)
+{
+    m_tiles = tiles;
+    m_animz = animz;
+    m_hideSpecial = hideSpecial;
+    for (size_t i = 0; i < MAX_TILES; ++i)
+        resolveFrame(static_cast<uint8_t>(i));
+}
+
+void CAnimator::resolveFrame(const uint8_t tileID)
+{
+    CFrame *&frame = m_frames[tileID];
+    frame = nullptr;
+    if (!m_tiles || (m_hideSpecial && (tileID == TILES_STOP || tileID == TILES_BLANK || isSpecialCase(tileID))))
+        return;
+    const uint16_t j = m_tileReplacement[tileID];
+    if (j == NO_ANIMZ)
+    {
+        if (tileID < m_tiles->getSize())
+            frame = (*m_tiles)[tileID];
+    }
+    else if (m_animz)
+    {
+        if (j < m_animz->getSize())
+            frame = (*m_animz)[j];
+    }
+}
+
 uint16_t CAnimator::at(uint8_t tileID) const
 {
     return m_tileReplacement[tileID];
@@ -113,6 +150,11 @@ bool CAnimator::isSpecialCase(uint8_t tileID) const
     return g_specialCases.find(tileID) != g_specialCases.end();
 }
 
+bool CAnimator::isAnimated(uint8_t tileID) const
+{
+    return m_seqLookUp.find(tileID) != m_seqLookUp.end();
+}
+
 animzInfo_t CAnimator::getSpecialInfo(const int tileID) const
 {
     const auto &it = m_seqLookUp.find(tileID);
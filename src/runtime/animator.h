@@ -22,6 +22,9 @@
 #include <vector>
 #include <array>
 
+class CFrame;
+class CFrameSet;
+
 struct animzInfo_t
 {
     uint8_t frames;
@@ -38,7 +41,11 @@ public:
     uint16_t at(uint8_t tileID) const;
     uint16_t offset() const;
     bool isSpecialCase(uint8_t tileID) const;
+    bool isAnimated(uint8_t tileID) const;
     animzInfo_t getSpecialInfo(const int tileID) const;
+    void setFrameSets(CFrameSet *tiles, CFrameSet *animz, const bool hideSpecial);
+    /// Frame to draw for a tile at the current animation step; nullptr if none.
+    inline CFrame *frame(const uint8_t tileID) const { return m_frames[tileID]; }
 
     struct animzSeq_t
     {
@@ -60,4 +67,10 @@ private:
     std::vector<int32_t> m_seqIndex;
     uint16_t m_offset = 0;
     std::unordered_map<uint16_t, animzInfo_t> m_seqLookUp;
+    /// Resolved frame of each tile, refreshed by animate().
+    std::array<CFrame *, MAX_TILES> m_frames{};
+    CFrameSet *m_tiles = nullptr;
+    CFrameSet *m_animz = nullptr;
+    bool m_hideSpecial = false;
+    void resolveFrame(const uint8_t tileID);
 };
@@ -0,0 +1,277 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <thread>
+#include <unordered_map>
+#include "archreport.h"
+#include "maparch.h"
+#include "game.h"
+#include "statedata.h"
+#include "tilesdefs.h"
+#include "sprtypes.h"
+#include "shared/IFile.h"
+
+namespace ArchReportPrivate
+{
+    constexpr size_t LINE_SIZE = 512;
+
+    void appendf(std::string &out, const char *fmt, ...)
+    {
+        char tmp[LINE_SIZE];
+        va_list args;
+        va_start(args, fmt);
+        vsnprintf(tmp, sizeof(tmp), fmt, args);
+        va_end(args);
+        out += tmp;
+    }
+
+    void appendJSON(std::string &out, const std::string &str)
+    {
+        out += '"';
+        for (const char c : str)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if (static_cast<uint8_t>(c) < 0x20)
+                appendf(out, "\\u%.4x", c);
+            else
+                out += c;
+        }
+        out += '"';
+    }
+
+    const std::unordered_map<uint16_t, std::string> &stateLabels()
+    {
+        static const std::unordered_map<uint16_t, std::string> labels = []()
+        {
+            std::unordered_map<uint16_t, std::string> labels;
+            for (const auto &option : getKeyOptions())
+                labels[option.value] = option.display;
+            return labels;
+        }();
+        return labels;
+    }
+};
+
+using namespace ArchReportPrivate;
+
+/**
+ * @brief Gather the statistics of every map
+ *
+ * @param arch
+ * @param jobs worker count, 0 for all cores
+ */
+void CArchReport::build(CMapArch &arch, unsigned jobs)
+{
+    const uint32_t count = arch.size();
+    m_stats.assign(count, mapStats_t{});
+    if (jobs == 0)
+        jobs = std::thread::hardware_concurrency();
+    jobs = std::max(1u, std::min<unsigned>(jobs, count));
+
+    std::atomic<uint32_t> next{0};
+    auto worker = [this, &arch, &next, count]()
+    {
+        for (uint32_t i = next++; i < count; i = next++)
+            scanMap(*arch.at(i), m_stats[i]);
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < jobs; ++i)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &thread : workers)
+        thread.join();
+
+    m_usage.fill(0);
+    for (const mapStats_t &stats : m_stats)
+    {
+        for (size_t tile = 0; tile < m_usage.size(); ++tile)
+            m_usage[tile] += stats.usage[tile];
+    }
+    m_uniqueTiles = std::count_if(m_usage.begin(), m_usage.end(), [](const uint32_t n)
+                                  { return n != 0; });
+}
+
+void CArchReport::scanMap(CMap &map, mapStats_t &stats)
+{
+    stats.title = map.title();
+    stats.len = map.len();
+    stats.hei = map.hei();
+    CGame::countTiles(map, stats.usage);
+    stats.report = CGame::generateMapReport(stats.usage, map.attrs());
+    stats.attrs = map.attrs().size();
+
+    // classify each tile once instead of each cell
+    for (size_t tile = 0; tile < stats.usage.size(); ++tile)
+    {
+        const uint32_t n = stats.usage[tile];
+        if (n == 0)
+            continue;
+        ++stats.uniqueTiles;
+        const TileDef &def = getTileDef(tile);
+        if (def.type == TYPE_MONSTER || def.type == TYPE_VAMPLANT)
+            stats.monsters += n;
+        else if (def.type == TYPE_STOP)
+            stats.stops += n;
+    }
+
+    const CStates &states = map.statesConst();
+    stats.parTime = states.getU(PAR_TIME);
+    stats.states = states.getValues();
+    std::sort(stats.states.begin(), stats.states.end(), [](const StateValuePair &a, const StateValuePair &b)
+              { return a.key < b.key; });
+}
+
+/**
+ * @brief Write the report
+ *
+ * @param file
+ * @param json JSON instead of text
+ * @return true
+ * @return false
+ */
+bool CArchReport::write(IFile &file, const bool json) const
+{
+    return json ? writeJSON(file) : writeText(file);
+}
+
+bool CArchReport::writeText(IFile &file) const
+{
+    std::string out;
+    out += "Map List\n";
+    out += "========\n\n";
+    for (size_t i = 0; i < m_stats.size(); ++i)
+        appendf(out, "Level %.2zu: %s\n", i + 1, m_stats[i].title.c_str());
+    out += "\n";
+    out += "MapArch statistics\n";
+    out += "==================\n\n";
+    bool ok = file += out;
+
+    const auto &labels = stateLabels();
+    auto writeItem = [&out](const char *str, const uint32_t v)
+    {
+        appendf(out, "  -- %-15s: %d\n", str, static_cast<int>(v));
+    };
+    for (size_t i = 0; i < m_stats.size(); ++i)
+    {
+        const mapStats_t &stats = m_stats[i];
+        out.clear();
+        appendf(out, "Level %.2zu: %s\n", i + 1, stats.title.c_str());
+        writeItem("Unique tiles", stats.uniqueTiles);
+        writeItem("Monsters", stats.monsters);
+        writeItem("Attributes", stats.attrs);
+        writeItem("Stops", stats.stops);
+        appendf(out, "  -- Size: %d x %d\n", stats.len, stats.hei);
+        writeItem("fruits", stats.report.fruits);
+        writeItem("treasures", stats.report.bonuses);
+        writeItem("secrets", stats.report.secrets);
+        if (stats.states.size())
+        {
+            out += "\nMeta-data\n";
+            for (const auto &item : stats.states)
+            {
+                const bool isStr = (item.key & 0xff) >= 0x80;
+                const auto it = labels.find(item.key);
+                const char *label = it != labels.end() ? it->second.c_str() : "";
+                appendf(out, "  -- %-12s %s", label, isStr ? item.value.c_str() : item.tip.c_str());
+                if (isStr)
+                    out += "\n";
+                else
+                    appendf(out, " [%s]\n", item.value.c_str());
+            }
+        }
+        out += "\n-----------------------------------\n";
+        out += "\n";
+        ok &= file += out;
+    }
+
+    out.clear();
+    out += "Par time\n";
+    out += "==================\n\n";
+    for (size_t i = 0; i < m_stats.size(); ++i)
+    {
+        const uint16_t parTime = m_stats[i].parTime;
+        if (parTime == 0)
+            continue;
+        appendf(out, "Level %.2zu: %s\n", i + 1, m_stats[i].title.c_str());
+        appendf(out, "   PAR TIME:   %.2d:%.2d\n\n", parTime / 60, parTime % 60);
+    }
+    appendf(out, "\nGlobal Unique tiles: %u\n", m_uniqueTiles);
+    ok &= file += out;
+    return ok;
+}
+
+bool CArchReport::writeJSON(IFile &file) const
+{
+    std::string out;
+    const auto &labels = stateLabels();
+    appendf(out, "{\n  \"maps\": %zu,\n  \"uniqueTiles\": %u,\n  \"levels\": [", m_stats.size(), m_uniqueTiles);
+    bool ok = file += out;
+    for (size_t i = 0; i < m_stats.size(); ++i)
+    {
+        const mapStats_t &stats = m_stats[i];
+        out.clear();
+        appendf(out, "%s\n    {\n      \"level\": %zu,\n      \"title\": ", i ? "," : "", i + 1);
+        appendJSON(out, stats.title);
+        appendf(out, ",\n      \"width\": %d,\n      \"height\": %d,\n      \"uniqueTiles\": %u,\n      \"monsters\": %u,\n      \"attributes\": %u,\n      \"stops\": %u,\n",
+                stats.len, stats.hei, stats.uniqueTiles, stats.monsters, stats.attrs, stats.stops);
+        appendf(out, "      \"fruits\": %d,\n      \"treasures\": %d,\n      \"secrets\": %d,\n      \"parTime\": %u,\n      \"states\": {",
+                stats.report.fruits, stats.report.bonuses, stats.report.secrets, stats.parTime);
+        for (size_t j = 0; j < stats.states.size(); ++j)
+        {
+            const auto &item = stats.states[j];
+            const auto it = labels.find(item.key);
+            char key[16];
+            snprintf(key, sizeof(key), "0x%.4x", item.key);
+            out += j ? ", " : "";
+            appendJSON(out, it != labels.end() ? it->second : key);
+            out += ": ";
+            appendJSON(out, item.value);
+        }
+        out += "},\n      \"tiles\": {";
+        bool first = true;
+        for (size_t tile = 0; tile < stats.usage.size(); ++tile)
+        {
+            if (stats.usage[tile] == 0)
+                continue;
+            appendf(out, "%s\"%zu\": %u", first ? "" : ", ", tile, stats.usage[tile]);
+            first = false;
+        }
+        out += "}\n    }";
+        ok &= file += out;
+    }
+
+    out = "\n  ],\n  \"tiles\": {";
+    bool first = true;
+    for (size_t tile = 0; tile < m_usage.size(); ++tile)
+    {
+        if (m_usage[tile] == 0)
+            continue;
+        appendf(out, "%s\"%zu\": %u", first ? "" : ", ", tile, m_usage[tile]);
+        first = false;
+    }
+    out += "}\n}\n";
+    ok &= file += out;
+    return ok;
+}
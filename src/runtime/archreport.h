@@ -0,0 +1,66 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "levelmeta.h"
+#include "states.h"
+
+class CMapArch;
+class IFile;
+
+/**
+ * @brief Statistics of every map of an archive, as text or JSON.
+ *
+ * The maps are scanned on a pool of threads, one map at a time per
+ * worker, into per-map results; the archive totals are merged in map
+ * order afterwards so the output doesn't depend on scheduling.
+ */
+class CArchReport
+{
+public:
+    struct mapStats_t
+    {
+        std::string title;
+        int len = 0;
+        int hei = 0;
+        tileUsage_t usage{};
+        uint32_t uniqueTiles = 0;
+        uint32_t monsters = 0;
+        uint32_t stops = 0;
+        uint32_t attrs = 0;
+        uint16_t parTime = 0;
+        MapReport report{0, 0, 0};
+        std::vector<StateValuePair> states; // by key
+    };
+
+    void build(CMapArch &arch, unsigned jobs = 0);
+    bool write(IFile &file, const bool json) const;
+    const std::vector<mapStats_t> &stats() const { return m_stats; }
+    const tileUsage_t &usage() const { return m_usage; }
+
+private:
+    std::vector<mapStats_t> m_stats;
+    tileUsage_t m_usage{};
+    uint32_t m_uniqueTiles = 0;
+    static void scanMap(CMap &map, mapStats_t &stats);
+    bool writeText(IFile &file) const;
+    bool writeJSON(IFile &file) const;
+};
@@ -0,0 +1,111 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cstring>
+#include "background.h"
+#include "animator.h"
+#include "blitter.h"
+#include "color.h"
+#include "map.h"
+#include "tilesdata.h"
+#include "shared/FrameSet.h"
+
+/**
+ * @brief Classify the tiles
+ *
+ * @param animator
+ */
+void CBackground::init(const CAnimator &animator)
+{
+    for (size_t i = 0; i < m_static.size(); ++i)
+    {
+        const uint8_t tileID = static_cast<uint8_t>(i);
+        m_static[i] = tileID != TILES_BLANK &&
+                      tileID != TILES_STOP &&
+                      tileID != TILES_ANNIE2 &&
+                      !animator.isSpecialCase(tileID) &&
+                      !animator.isAnimated(tileID);
+    }
+}
+
+/**
+ * @brief Bring a block of cells up to date with the map
+ *
+ * @param map
+ * @param tiles
+ * @param x first column
+ * @param y first row
+ * @param cols
+ * @param rows
+ */
+void CBackground::sync(const CMap &map, CFrameSet &tiles, const int x, const int y, const int cols, const int rows)
+{
+    if (map.len() != m_len || map.hei() != m_hei)
+    {
+        m_len = map.len();
+        m_hei = map.hei();
+        CFrame frame(m_len * TILE_SIZE, m_hei * TILE_SIZE);
+        swap(m_frame, frame);
+        m_drawn.assign(m_len * m_hei, NOT_DRAWN);
+    }
+
+    const int x1 = std::min(x + cols, m_len);
+    const int y1 = std::min(y + rows, m_hei);
+    const int pitch = m_frame.width();
+    blitOp_t op;
+    for (int row = std::max(y, 0); row < y1; ++row)
+    {
+        for (int col = std::max(x, 0); col < x1; ++col)
+        {
+            const uint8_t tileID = map.at(col, row);
+            uint16_t &drawn = m_drawn[col + row * m_len];
+            if (drawn == tileID)
+                continue;
+            drawn = tileID;
+            uint32_t *dest = m_frame.getRGB().data() + col * TILE_SIZE + row * TILE_SIZE * pitch;
+            if (m_static[tileID])
+            {
+                blit(dest, pitch, tiles[tileID]->getRGB().data(), TILE_SIZE, TILE_SIZE, TILE_SIZE, op);
+                continue;
+            }
+            for (int i = 0; i < TILE_SIZE; ++i)
+                std::fill(dest + i * pitch, dest + i * pitch + TILE_SIZE, BLACK);
+        }
+    }
+}
+
+/**
+ * @brief Copy part of the level to the top left corner of the bitmap
+ *
+ * @param bitmap
+ * @param sx first level pixel
+ * @param sy first level pixel
+ * @param width
+ * @param height
+ */
+void CBackground::draw(CFrame &bitmap, const int sx, const int sy, const int width, const int height)
+{
+    const int w = std::min({width, bitmap.width(), m_frame.width() - sx});
+    const int h = std::min({height, bitmap.height(), m_frame.height() - sy});
+    if (w <= 0 || h <= 0)
+        return;
+    const uint32_t *src = m_frame.getRGB().data() + sx + sy * m_frame.width();
+    uint32_t *dest = bitmap.getRGB().data();
+    for (int row = 0; row < h; ++row)
+        memcpy(dest + row * bitmap.width(), src + row * m_frame.width(), w * sizeof(uint32_t));
+}
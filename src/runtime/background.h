@@ -0,0 +1,61 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "shared/Frame.h"
+
+class CMap;
+class CFrameSet;
+class CAnimator;
+
+/**
+ * @brief The static tiles of a whole level, pre-rendered at full size.
+ *
+ * Static tiles are the ones that never change on screen: not animated,
+ * not a special case, not the player and not blank. The other cells are
+ * left black, to be drawn over every frame. The tile each cell was
+ * rendered with is remembered, so that sync() only redraws the cells
+ * whose tile was changed in the map since.
+ */
+class CBackground
+{
+public:
+    CBackground() = default;
+    ~CBackground() = default;
+
+    void init(const CAnimator &animator);
+    void sync(const CMap &map, CFrameSet &tiles, const int x, const int y, const int cols, const int rows);
+    void draw(CFrame &bitmap, const int sx, const int sy, const int width, const int height);
+    inline bool isStatic(const uint8_t tileID) const { return m_static[tileID]; }
+
+private:
+    enum : uint16_t
+    {
+        NOT_DRAWN = 0xffff,
+        TILE_SIZE = 16,
+    };
+
+    std::array<bool, 256> m_static{};
+    std::vector<uint16_t> m_drawn; // tile of each cell, as rendered
+    int m_len = 0;
+    int m_hei = 0;
+    CFrame m_frame;
+};
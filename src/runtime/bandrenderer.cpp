@@ -0,0 +1,124 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include "bandrenderer.h"
+
+/**
+ * @brief Start the workers
+ *
+ * @param threads including the calling thread, 0 for all cores
+ */
+CBandRenderer::CBandRenderer(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::min<unsigned>(std::thread::hardware_concurrency(), MAX_THREADS);
+    threads = std::max(1u, threads);
+    for (unsigned i = 1; i < threads; ++i)
+        m_workers.emplace_back(&CBandRenderer::worker, this);
+}
+
+CBandRenderer::~CBandRenderer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (auto &thread : m_workers)
+        thread.join();
+}
+
+/**
+ * @brief Number of bands a job of this many rows is split into
+ *
+ * @param rows
+ * @return int
+ */
+int CBandRenderer::bandCount(const int rows) const
+{
+    if (rows <= 0)
+        return 0;
+    const int most = static_cast<int>(threads()) * BANDS_PER_THREAD;
+    return std::clamp(rows / MIN_BAND_ROWS, 1, most);
+}
+
+/**
+ * @brief Draw every band and wait for all of them
+ *
+ * @param rows tile rows to draw
+ * @param fn called once per band, from any thread
+ * @return int bands drawn
+ */
+int CBandRenderer::run(const int rows, const bandFn_t &fn)
+{
+    const int bands = bandCount(rows);
+    if (bands <= 1 || m_workers.empty())
+    {
+        if (rows > 0)
+            fn(0, 0, rows);
+        return std::min(bands, 1);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fn = &fn;
+        m_rows = rows;
+        m_bands = bands;
+        m_next = 0;
+        m_pending = m_workers.size();
+        ++m_job;
+    }
+    m_wake.notify_all();
+    drain();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]()
+                { return m_pending == 0; });
+    m_fn = nullptr;
+    return bands;
+}
+
+void CBandRenderer::worker()
+{
+    uint32_t job = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, job]()
+                        { return m_quit || m_job != job; });
+            if (m_quit)
+                return;
+            job = m_job;
+        }
+        drain();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0)
+            m_done.notify_one();
+    }
+}
+
+/**
+ * @brief Draw bands until none is left; band boundaries only depend on
+ *        the row count, never on the thread
+ */
+void CBandRenderer::drain()
+{
+    for (int band = m_next++; band < m_bands; band = m_next++)
+        (*m_fn)(band, m_rows * band / m_bands, m_rows * (band + 1) / m_bands);
+}
@@ -0,0 +1,73 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Splits a frame into bands of tile rows and draws them on a pool
+ *        of threads kept for the lifetime of the renderer.
+ *
+ * Each band owns the pixel rows of its tile rows, so the bands are drawn
+ * without locking and the result doesn't depend on which thread drew
+ * which band. Whatever crosses band boundaries (sprites, bosses) is left
+ * to the caller, once run() returns. The calling thread draws bands too;
+ * a job too small to be split is drawn inline.
+ */
+class CBandRenderer
+{
+public:
+    /// band index, first row, one past the last row
+    using bandFn_t = std::function<void(const int band, const int first, const int last)>;
+
+    explicit CBandRenderer(unsigned threads = 0);
+    ~CBandRenderer();
+
+    int bandCount(const int rows) const;
+    int run(const int rows, const bandFn_t &fn);
+    unsigned threads() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+    enum : int
+    {
+        MIN_BAND_ROWS = 2,
+        BANDS_PER_THREAD = 2,
+        MAX_THREADS = 8,
+    };
+
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const bandFn_t *m_fn = nullptr;
+    int m_rows = 0;
+    int m_bands = 0;
+    std::atomic<int> m_next{0};
+    size_t m_pending = 0; // workers still on the current job
+    uint32_t m_job = 0;
+    bool m_quit = false;
+
+    void worker();
+    void drain();
+};
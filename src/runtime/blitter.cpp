@@ -0,0 +1,257 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <utility>
+#include "blitter.h"
+#include "color.h"
+#include "colormap.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BLIT_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace BlitterPrivate
+{
+    constexpr int TILE_SIZE = 16;
+    constexpr int MAP_CHUNK = 64; // pixels remapped at a time
+    constexpr size_t KERNEL_COUNT = size_t(BLIT_TRANSPARENCY_COUNT) * BLIT_EFFECT_COUNT * 2;
+
+    struct blitArgs_t
+    {
+        uint32_t *dest;
+        const uint32_t *src;
+        const uint32_t *key; // pixels tested for transparency
+        int destPitch;
+        int srcPitch;
+        int keyPitch;
+        int width;
+        int height;
+        int shift;
+        uint32_t filter;
+    };
+
+    using kernel_t = void (*)(const blitArgs_t &);
+
+    struct kernelTable_t
+    {
+        kernel_t any[KERNEL_COUNT];
+        kernel_t tile[KERNEL_COUNT]; // TILE_SIZE wide
+        const char *name;
+    };
+
+    struct Scalar
+    {
+        using reg = uint32_t;
+        static constexpr int LANES = 1;
+        static inline reg load(const uint32_t *p) { return *p; }
+        static inline void store(uint32_t *p, const reg v) { *p = v; }
+        static inline reg set1(const uint32_t v) { return v; }
+        static inline reg and_(const reg a, const reg b) { return a & b; }
+        static inline reg or_(const reg a, const reg b) { return a | b; }
+        static inline reg xor_(const reg a, const reg b) { return a ^ b; }
+        static inline reg srl(const reg v, const int n) { return v >> n; }
+        static inline reg isZero(const reg v) { return v ? 0 : ~0u; }
+        static inline reg select(const reg mask, const reg a, const reg b) { return mask ? a : b; }
+        static inline reg gray(const reg c)
+        {
+            const uint32_t avg = ((c & 0xff) + ((c >> 8) & 0xff) + ((c >> 16) & 0xff)) / 3;
+            return (c & ALPHA) | avg * 0x010101;
+        }
+    };
+
+    namespace BlitterScalar
+    {
+        using Vec = Scalar;
+#include "blitkernel.inc"
+    };
+
+#if defined(BLIT_X86)
+    struct Sse2
+    {
+        using reg = __m128i;
+        static constexpr int LANES = 4;
+        static inline reg load(const uint32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+        static inline void store(uint32_t *p, const reg v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+        static inline reg set1(const uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+        static inline reg and_(const reg a, const reg b) { return _mm_and_si128(a, b); }
+        static inline reg or_(const reg a, const reg b) { return _mm_or_si128(a, b); }
+        static inline reg xor_(const reg a, const reg b) { return _mm_xor_si128(a, b); }
+        static inline reg srl(const reg v, const int n) { return _mm_srl_epi32(v, _mm_cvtsi32_si128(n)); }
+        static inline reg isZero(const reg v) { return _mm_cmpeq_epi32(v, _mm_setzero_si128()); }
+        static inline reg select(const reg mask, const reg a, const reg b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+        static inline reg gray(const reg c)
+        {
+            // (r + g + b) / 3 as (sum * 21846) >> 16, exact for sums up to 765
+            const reg byte = _mm_set1_epi32(0xff);
+            const reg sum = _mm_add_epi32(_mm_add_epi32(_mm_and_si128(c, byte), _mm_and_si128(_mm_srli_epi32(c, 8), byte)),
+                                          _mm_and_si128(_mm_srli_epi32(c, 16), byte));
+            const reg avg = _mm_mulhi_epu16(sum, _mm_set1_epi32(21846));
+            return _mm_or_si128(_mm_and_si128(c, set1(ALPHA)), _mm_or_si128(avg, _mm_or_si128(_mm_slli_epi32(avg, 8), _mm_slli_epi32(avg, 16))));
+        }
+    };
+
+    namespace BlitterSSE2
+    {
+        using Vec = Sse2;
+#include "blitkernel.inc"
+    };
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+    struct Avx2
+    {
+        using reg = __m256i;
+        static constexpr int LANES = 8;
+        static inline reg load(const uint32_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+        static inline void store(uint32_t *p, const reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+        static inline reg set1(const uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+        static inline reg and_(const reg a, const reg b) { return _mm256_and_si256(a, b); }
+        static inline reg or_(const reg a, const reg b) { return _mm256_or_si256(a, b); }
+        static inline reg xor_(const reg a, const reg b) { return _mm256_xor_si256(a, b); }
+        static inline reg srl(const reg v, const int n) { return _mm256_srl_epi32(v, _mm_cvtsi32_si128(n)); }
+        static inline reg isZero(const reg v) { return _mm256_cmpeq_epi32(v, _mm256_setzero_si256()); }
+        static inline reg select(const reg mask, const reg a, const reg b) { return _mm256_blendv_epi8(b, a, mask); }
+        static inline reg gray(const reg c)
+        {
+            const reg byte = _mm256_set1_epi32(0xff);
+            const reg sum = _mm256_add_epi32(_mm256_add_epi32(_mm256_and_si256(c, byte), _mm256_and_si256(_mm256_srli_epi32(c, 8), byte)),
+                                             _mm256_and_si256(_mm256_srli_epi32(c, 16), byte));
+            const reg avg = _mm256_mulhi_epu16(sum, _mm256_set1_epi32(21846));
+            return _mm256_or_si256(_mm256_and_si256(c, set1(ALPHA)), _mm256_or_si256(avg, _mm256_or_si256(_mm256_slli_epi32(avg, 8), _mm256_slli_epi32(avg, 16))));
+        }
+    };
+
+    namespace BlitterAVX2
+    {
+        using Vec = Avx2;
+#include "blitkernel.inc"
+    };
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+    bool hasAVX2()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, 7, 0);
+        const bool avx2 = info[1] & (1 << 5);
+        __cpuid(info, 1);
+        const bool osxsave = info[2] & (1 << 27);
+        return avx2 && osxsave && (_xgetbv(0) & 6) == 6;
+#else
+        return false;
+#endif
+    }
+#endif
+
+    const kernelTable_t &kernels()
+    {
+        static const kernelTable_t table = []()
+        {
+            kernelTable_t table;
+#if defined(BLIT_X86)
+            if (hasAVX2())
+            {
+                BlitterAVX2::getKernels(table);
+                table.name = "avx2";
+                return table;
+            }
+            BlitterSSE2::getKernels(table);
+            table.name = "sse2";
+#else
+            BlitterScalar::getKernels(table);
+            table.name = "scalar";
+#endif
+            return table;
+        }();
+        return table;
+    }
+};
+
+using namespace BlitterPrivate;
+
+/**
+ * @brief Draw a block of pixels
+ *
+ * @param dest first destination pixel
+ * @param destPitch pixels per destination row
+ * @param src first source pixel
+ * @param srcPitch pixels per source row
+ * @param width
+ * @param height
+ * @param op transparency and colour effects
+ */
+void blit(uint32_t *dest, const int destPitch, const uint32_t *src, const int srcPitch, const int width, const int height, const blitOp_t &op)
+{
+    if (width <= 0 || height <= 0)
+        return;
+    const kernelTable_t &table = kernels();
+    const size_t index = (size_t(op.transparency) * BLIT_EFFECT_COUNT + op.effect) * 2 + (op.shift ? 1 : 0);
+    blitArgs_t args{dest, src, src, destPitch, srcPitch, srcPitch, width, height, op.shift, (0xffu >> op.shift) * 0x010101};
+    if (!op.colorMap)
+    {
+        (width == TILE_SIZE ? table.tile[index] : table.any[index])(args);
+        return;
+    }
+
+    // remap a chunk of a row at a time; transparency is still tested
+    // on the original pixels
+    uint32_t mapped[MAP_CHUNK];
+    const kernel_t kernel = table.any[index];
+    const auto &colorMap = *op.colorMap;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; x += MAP_CHUNK)
+        {
+            const int count = std::min(MAP_CHUNK, width - x);
+            const uint32_t *in = src + y * srcPitch + x;
+            colorMap.remap(in, mapped, count);
+            blitArgs_t chunk = args;
+            chunk.dest = dest + y * destPitch + x;
+            chunk.src = mapped;
+            chunk.key = in;
+            chunk.width = count;
+            chunk.height = 1;
+            kernel(chunk);
+        }
+    }
+}
+
+/**
+ * @brief Name of the kernels in use
+ *
+ * @return const char*
+ */
+const char *blitKernel()
+{
+    return kernels().name;
+}
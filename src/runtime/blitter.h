@@ -0,0 +1,59 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+
+class CColorMap;
+
+enum BlitTransparency : uint8_t
+{
+    BLIT_OPAQUE,
+    BLIT_SKIP_CLEAR, // skip pixels equal to 0
+    BLIT_SKIP_ALPHA, // skip pixels without alpha
+    BLIT_TRANSPARENCY_COUNT,
+};
+
+enum BlitEffect : uint8_t
+{
+    BLIT_NOCHANGE,
+    BLIT_INVERTED,
+    BLIT_GRAYSCALE,
+    BLIT_ALL_WHITE,
+    BLIT_EFFECT_COUNT,
+};
+
+struct blitOp_t
+{
+    BlitTransparency transparency = BLIT_OPAQUE;
+    BlitEffect effect = BLIT_NOCHANGE;
+    uint8_t shift = 0; // fade: (color >> shift) & filter, 0 for none
+    const CColorMap *colorMap = nullptr;
+};
+
+/**
+ * @brief Copy a block of pixels, with transparency and colour effects.
+ *
+ * The colour map is applied first, then the fade, then the effect. The
+ * transparency test is made on the source pixel. The kernels are
+ * specialized for each combination at compile time and for full tiles,
+ * and the instruction set (AVX2, SSE2 or plain C++) is chosen on first
+ * use from what the CPU supports.
+ */
+void blit(uint32_t *dest, const int destPitch, const uint32_t *src, const int srcPitch, const int width, const int height, const blitOp_t &op);
+const char *blitKernel();
@@ -40,28 +40,26 @@ namespace BossPrivate
 
 using namespace BossPrivate;
 
-CBoss::CBoss(const int16_t x, const int16_t y, const bossData_t *data) : m_bossData(data)
+CBoss::CBoss(const int16_t x, const int16_t y, const bossData_t *data, const int skill) : m_bossData(data)
 {
     m_x = x;
     m_y = y;
     m_speed = data->speed;
     m_state = Patrol;
     m_framePtr = 0;
-    m_hp = maxHp(); // data->hp;
+    m_hp = maxHp(skill); // data->hp;
     setSolidOperator();
 }
 
-bool CBoss::isSolid(const Pos &pos) const
+bool CBoss::isSolid(const CMap &map, const Pos &pos) const
 {
-    CMap &map = CGame::getMap();
     const auto c = map.at(pos.x, pos.y);
     const TileDef &def = getTileDef(c);
     return def.type != TYPE_BACKGROUND && def.type != TYPE_PLAYER;
 }
 
-bool CBoss::isGhostBlocked(const Pos &pos) const
+bool CBoss::isGhostBlocked(const CMap &map, const Pos &pos) const
 {
-    CMap &map = CGame::getMap();
     const auto c = map.at(pos.x, pos.y);
     const TileDef &def = getTileDef(c);
     return def.type == TYPE_SWAMP || def.type == TYPE_ICECUBE || c == TILES_WALLS93_3;
@@ -224,9 +222,9 @@ std::vector<HitResult> CBoss::testHitbox1(const CMap &map,
     return results;
 }
 
-bool CBoss::canMove(const JoyAim aim) const
+bool CBoss::canMove(const CGame &game, const JoyAim aim) const
 {
-    const CMap &map = CGame::getMap();
+    const CMap &map = game.map();
     const int mapLen = map.len();
     const int mapHei = map.hei();
     const int x = m_x / BOSS_GRANULAR_FACTOR;
@@ -276,7 +274,7 @@ bool CBoss::canMove(const JoyAim aim) const
             if (ax < 0 || ax >= mapLen)
                 continue;
             const Pos pos{static_cast<int16_t>(ax), static_cast<int16_t>(y - 1)};
-            if ((this->*m_solidCheck)(pos))
+            if ((this->*m_solidCheck)(map, pos))
                 return false;
         }
         break;
@@ -289,7 +287,7 @@ bool CBoss::canMove(const JoyAim aim) const
             if (ax < 0 || ax >= mapLen)
                 continue;
             const Pos pos{static_cast<int16_t>(ax), static_cast<int16_t>(y + h)};
-            if ((this->*m_solidCheck)(pos))
+            if ((this->*m_solidCheck)(map, pos))
                 return false;
         }
         break;
@@ -302,7 +300,7 @@ bool CBoss::canMove(const JoyAim aim) const
             if (ay < 0 || ay >= mapHei)
                 continue;
             const Pos pos{static_cast<int16_t>(x - 1), static_cast<int16_t>(ay)};
-            if ((this->*m_solidCheck)(pos))
+            if ((this->*m_solidCheck)(map, pos))
                 return false;
         }
         break;
@@ -315,7 +313,7 @@ bool CBoss::canMove(const JoyAim aim) const
             if (ay < 0 || ay >= mapHei)
                 continue;
             const Pos pos{static_cast<int16_t>(x + w), static_cast<int16_t>(ay)};
-            if ((this->*m_solidCheck)(pos))
+            if ((this->*m_solidCheck)(map, pos))
                 return false;
         }
         break;
@@ -326,7 +324,7 @@ bool CBoss::canMove(const JoyAim aim) const
     return true;
 }
 
-void CBoss::move(const JoyAim aim)
+void CBoss::move(CGame &, const JoyAim aim)
 {
     switch (aim)
     {
@@ -437,9 +435,8 @@ void CBoss::setState(const BossState state)
     m_framePtr = 0;
 };
 
-int CBoss::maxHp() const
+int CBoss::maxHp(const int skill) const
 {
-    auto skill = (int)CGame::getGame()->skill();
     return (int)m_bossData->hp * ((skill * 0.5) + 1);
 }
 
@@ -484,20 +481,20 @@ const Pos CBoss::toPos(int x, int y)
     return Pos{static_cast<int16_t>(x), static_cast<int16_t>(y)};
 }
 
-bool CBoss::followPath(const Pos &playerPos, const IPath &astar)
+bool CBoss::followPath(CGame &game, const Pos &playerPos, const IPath &astar)
 {
-    return m_path.followPath(*this, playerPos, astar) == CPath::Result::MoveSuccesful;
+    return m_path.followPath(game, *this, playerPos, astar) == CPath::Result::MoveSuccesful;
 }
 
-void CBoss::patrol()
+void CBoss::patrol(CGame &game)
 {
     constexpr JoyAim dirs[] = {AIM_UP, AIM_DOWN, AIM_LEFT, AIM_RIGHT};
-    Random &rng = CGame::getRandom();
+    Random &rng = game.rng();
     int dir = rng.range(0, 4); // Choose random direction
     JoyAim aim = dirs[dir];
-    if (canMove(aim))
+    if (canMove(game, aim))
     {
-        move(aim);
+        move(game, aim);
     }
 }
 
@@ -30,6 +30,7 @@ class IFile;
 class CActor;
 class CPath;
 class CBoss;
+class CGame;
 
 struct HitResult
 {
@@ -39,7 +40,7 @@ struct HitResult
 
 using hitboxTestCallback_t = std::function<bool(const Pos &, BossData::HitBoxType)>; // Return true to skip/abort this pos
 using hitboxActionCallback_t = std::function<void(const HitResult &)>;               // Collect/process each hit
-using BossTileCheck = bool (CBoss::*)(const Pos &) const;
+using BossTileCheck = bool (CBoss::*)(const CMap &, const Pos &) const;
 
 class CBoss : public ISprite
 {
@@ -55,7 +56,7 @@ public:
         Hidden,
         MAX_STATES
     };
-    CBoss(const int16_t x = 0, const int16_t y = 0, const bossData_t *data = nullptr);
+    CBoss(const int16_t x = 0, const int16_t y = 0, const bossData_t *data = nullptr, const int skill = 0);
     virtual ~CBoss() {};
     inline int16_t x() const override { return m_x; }
     inline int16_t y() const override { return m_y; }
@@ -64,17 +65,17 @@ public:
     std::vector<HitResult> testHitbox1(const CMap &map, hitboxTestCallback_t testCallback, hitboxActionCallback_t actionCallback) const;
     std::vector<HitResult> testHitbox2(const CMap &map, hitboxTestCallback_t testCallback, hitboxActionCallback_t actionCallback) const;
 
-    bool isSolid(const Pos &pos) const;
-    bool isGhostBlocked(const Pos &pos) const;
+    bool isSolid(const CMap &map, const Pos &pos) const;
+    bool isGhostBlocked(const CMap &map, const Pos &pos) const;
     static const Pos toPos(int x, int y);
-    bool canMove(const JoyAim aim) const override;
-    void move(const JoyAim aim) override;
+    bool canMove(const CGame &game, const JoyAim aim) const override;
+    void move(CGame &game, const JoyAim aim) override;
     int distance(const CActor &actor) const override;
     int speed() const { return m_speed; }
     void setSpeed(int speed) { m_speed = speed; }
     void setHP(const int hp) { m_hp = hp; }
     int hp() const { return m_hp; }
-    int maxHp() const;
+    int maxHp(const int skill) const;
     bool subtainDamage(const int lostHP);
     bool isHidden() const { return m_state == Hidden; }
     bool isDone() const { return m_state == Hidden; }
@@ -111,8 +112,8 @@ public:
     {
         BOSS_GRANULAR_FACTOR = 2,
     };
-    bool followPath(const Pos &playerPos, const IPath &astar);
-    void patrol();
+    bool followPath(CGame &game, const Pos &playerPos, const IPath &astar);
+    void patrol(CGame &game);
     bool read(IFile &file);
     bool write(IFile &file);
     void setAim(const JoyAim aim) override { m_aim = aim; };
@@ -129,7 +130,7 @@ private:
     int m_hp;
     BossState m_state;
     int m_speed;
-    JoyAim m_aim;
+    JoyAim m_aim = AIM_NONE;
     BossTileCheck m_solidCheck = nullptr;
     void setSolidOperator();
     CPath m_path;
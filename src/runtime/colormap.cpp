@@ -21,6 +21,16 @@
 #include <cstring>
 #include "logger.h"
 
+namespace ColorMapPrivate
+{
+    constexpr int MIN_BITS = 2;
+    constexpr int EXTRA_BITS = 2;        // table growth allowed for a perfect hash
+    constexpr int MULTIPLIER_TRIES = 64; // per table size
+    constexpr uint32_t GOLDEN = 0x9e3779b1;
+};
+
+using namespace ColorMapPrivate;
+
 bool parseListKV(std::vector<std::string> &list, uint32_t &k, uint32_t &v, const int line)
 {
     if (list.size() != 2)
@@ -56,12 +66,97 @@ bool parseColorMaps(IFile &file, ColorMaps &colorMaps)
     return parseColorMaps(buffer.data(), colorMaps);
 }
 
+/**
+ * @brief Replace the mappings and rebuild the table
+ *
+ * @param pairs color -> replacement
+ */
+void CColorMap::assign(const std::unordered_map<uint32_t, uint32_t> &pairs)
+{
+    clear();
+    if (pairs.empty())
+        return;
+
+    // a free slot marker that can't be mistaken for a key
+    while (pairs.count(m_empty))
+        ++m_empty;
+
+    int bits = MIN_BITS;
+    while ((size_t(1) << bits) < pairs.size() * 2)
+        ++bits;
+
+    // look for a collision free multiplier, allowing the table to grow a bit
+    uint32_t seed = GOLDEN;
+    for (int extra = 0; extra <= EXTRA_BITS; ++extra)
+    {
+        for (int i = 0; i < MULTIPLIER_TRIES; ++i)
+        {
+            if (build(pairs, bits + extra, seed | 1, true))
+                return;
+            seed = seed * 1664525 + 1013904223;
+        }
+    }
+    build(pairs, bits, GOLDEN, false);
+}
+
+bool CColorMap::build(const std::unordered_map<uint32_t, uint32_t> &pairs, const int bits, const uint32_t multiplier, const bool perfect)
+{
+    m_mask = (uint32_t(1) << bits) - 1;
+    m_shift = 32 - bits;
+    m_multiplier = multiplier;
+    m_keys.assign(size_t(m_mask) + 1, m_empty);
+    m_values.assign(size_t(m_mask) + 1, m_empty);
+    for (const auto &[key, value] : pairs)
+    {
+        uint32_t i = slot(key);
+        if (perfect && m_keys[i] != m_empty)
+            return false;
+        while (m_keys[i] != m_empty)
+            i = (i + 1) & m_mask;
+        m_keys[i] = key;
+        m_values[i] = value;
+    }
+    m_size = pairs.size();
+    return true;
+}
+
+void CColorMap::clear()
+{
+    m_keys.clear();
+    m_values.clear();
+    m_size = 0;
+    m_mask = 0;
+    m_shift = 32;
+    m_multiplier = 0;
+    m_empty = 0;
+}
+
+/**
+ * @brief Map a run of colors
+ *
+ * @param src
+ * @param dest may be src
+ * @param count
+ */
+void CColorMap::remap(const uint32_t *src, uint32_t *dest, const size_t count) const
+{
+    if (!m_size)
+    {
+        if (dest != src)
+            memmove(dest, src, count * sizeof(uint32_t));
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+        dest[i] = map(src[i]);
+}
+
 void clearColorMaps(ColorMaps &colorMaps)
 {
     // clear maps
     colorMaps.godMode.clear();
     colorMaps.rage.clear();
     colorMaps.sugarRush.clear();
+    ++colorMaps.version;
 }
 
 bool parseColorMaps(const char *tmp, ColorMaps &colorMaps)
@@ -72,11 +167,15 @@ bool parseColorMaps(const char *tmp, ColorMaps &colorMaps)
         return false;
     }
     clearColorMaps(colorMaps);
+    std::unordered_map<uint32_t, uint32_t> sugarRush;
+    std::unordered_map<uint32_t, uint32_t> godMode;
+    std::unordered_map<uint32_t, uint32_t> rage;
     const std::string input(tmp);
     size_t pos = 0;
     std::string section;
     int line = 1;
-    while (pos < input.size())
+    bool ok = true;
+    while (ok && pos < input.size())
     {
         const std::string current = processLine(input, pos);
         if (current.empty())
@@ -90,13 +189,15 @@ bool parseColorMaps(const char *tmp, ColorMaps &colorMaps)
             if (end == std::string::npos)
             {
                 LOGE("Missing section terminator on line %d", line);
-                return false;
+                ok = false;
+                break;
             }
             section = current.substr(1, end - 1);
             if (section.empty() || (section != "sugarrush" && section != "godmode" && section != "rage"))
             {
                 LOGE("Invalid section '%s' on line %d", section.c_str(), line);
-                return false;
+                ok = false;
+                break;
             }
         }
         else
@@ -106,27 +207,34 @@ bool parseColorMaps(const char *tmp, ColorMaps &colorMaps)
             uint32_t k, v;
             if (!parseListKV(list, k, v, line))
             {
-                return false;
+                ok = false;
+                break;
             }
             if (section == "sugarrush")
             {
-                colorMaps.sugarRush[k] = v;
+                sugarRush[k] = v;
             }
             else if (section == "godmode")
             {
-                colorMaps.godMode[k] = v;
+                godMode[k] = v;
             }
             else if (section == "rage")
             {
-                colorMaps.rage[k] = v;
+                rage[k] = v;
             }
             else
             {
                 LOGE("No section defined for key-value pair on line %d", line);
-                return false;
+                ok = false;
+                break;
             }
         }
         ++line;
     }
-    return !colorMaps.sugarRush.empty() || !colorMaps.godMode.empty() || !colorMaps.rage.empty();
+
+    // compile the tables once, at load; on error, keep what was read so far
+    colorMaps.sugarRush.assign(sugarRush);
+    colorMaps.godMode.assign(godMode);
+    colorMaps.rage.assign(rage);
+    return ok && (!colorMaps.sugarRush.empty() || !colorMaps.godMode.empty() || !colorMaps.rage.empty());
 }
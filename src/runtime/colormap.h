@@ -18,10 +18,57 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 #include <cstdint>
+#include <cstddef>
 
 class IFile;
-using colorMap_t = std::unordered_map<uint32_t, uint32_t>;
+
+/// Color substitution table, compiled into an open-addressed hash table.
+/// The multiplier of the hash is searched so that, in practice, every
+/// color is found on the first probe; colors not in the table map to
+/// themselves.
+class CColorMap
+{
+public:
+    /// Replaces the mappings and rebuilds the table.
+    void assign(const std::unordered_map<uint32_t, uint32_t> &pairs);
+    void clear();
+    inline bool empty() const { return m_size == 0; }
+    inline size_t size() const { return m_size; }
+
+    /// Maps a single color.
+    inline uint32_t map(const uint32_t color) const
+    {
+        if (!m_size)
+            return color;
+        for (uint32_t i = slot(color);; i = (i + 1) & m_mask)
+        {
+            const uint32_t key = m_keys[i];
+            if (key == color)
+                return m_values[i];
+            if (key == m_empty)
+                return color;
+        }
+    }
+
+    /// Maps count colors from src into dest; both may be the same buffer.
+    void remap(const uint32_t *src, uint32_t *dest, const size_t count) const;
+
+private:
+    inline uint32_t slot(const uint32_t color) const { return (color * m_multiplier) >> m_shift; }
+    bool build(const std::unordered_map<uint32_t, uint32_t> &pairs, const int bits, const uint32_t multiplier, const bool perfect);
+
+    std::vector<uint32_t> m_keys;
+    std::vector<uint32_t> m_values;
+    size_t m_size = 0;
+    uint32_t m_mask = 0;
+    uint32_t m_shift = 32;
+    uint32_t m_multiplier = 0;
+    uint32_t m_empty = 0; ///< Marks free slots; never a key.
+};
+
+using colorMap_t = CColorMap;
 
 /// Stores color mappings for game effects.
 struct ColorMaps
@@ -29,6 +76,7 @@ struct ColorMaps
     colorMap_t sugarRush; ///< Color mappings for sugar rush mode.
     colorMap_t godMode;   ///< Color mappings for god mode.
     colorMap_t rage;      ///< Color mappings for rage mode.
+    uint32_t version = 0; ///< Bumped each time the mappings are cleared or reloaded.
 };
 
 /// Clears all color mappings.
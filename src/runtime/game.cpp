@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <memory>
 #include <array>
+#include <zlib.h>
 #include "game.h"
 #include "map.h"
 #include "actor.h"
@@ -47,12 +48,16 @@
 #include "gamesfx.h"
 #include "boss.h"
 #include "tilesdefs.h"
+#include "prefetch.h"
+#include "shared/FileMem.h"
+#include "shared/helper.h"
 
 namespace GamePrivate
 {
-    constexpr uint32_t ENGINE_VERSION = (0x0200 << 16) + 0x0008;
+    constexpr uint32_t ENGINE_VERSION = (0x0200 << 16) + 0x0009;
+    // savegames storing the whole map uncompressed
+    constexpr uint32_t FULLMAP_ENGINE_VERSION = (0x0200 << 16) + 0x0008;
     constexpr const char GAME_SIGNATURE[]{'C', 'S', '3', 'b'};
-    Random g_randomz(12345, 0);
 
     enum
     {
@@ -74,6 +79,18 @@ namespace GamePrivate
         MAX_FACTOR = 4,
         BARREL_TTL = 20,
     };
+
+    enum : uint8_t
+    {
+        SAVEMAP_FULL,
+        SAVEMAP_DELTA,
+        SAVEMAP_PLANE, // snapshots: the tiles are kept apart
+    };
+    // key (uint16) + value
+    constexpr size_t DELTA_ENTRY_SIZE = 3;
+    // savegame body: a whole 256x256 map with an attribute on every cell
+    // takes under 400KB, so anything above this is a corrupt header
+    constexpr uint32_t MAX_SAVE_BODY = 16 * 1024 * 1024;
 }
 
 using namespace GamePrivate;
@@ -105,13 +122,13 @@ CGame::~CGame()
 }
 
 /**
- * @brief returns the current map
+ * @brief returns the map of the default session
  *
  * @return CMap&
  */
 CMap &CGame::getMap()
 {
-    return m_map;
+    return getGame()->m_map;
 }
 
 /**
@@ -166,11 +183,11 @@ bool CGame::fuseBarrel(const Pos &pos)
  */
 bool CGame::move(const JoyAim aim)
 {
-    const uint8_t tileID = m_player.tileAt(aim);
+    const uint8_t tileID = m_player.tileAt(*this, aim);
     const TileDef &def = getTileDef(tileID);
-    if (m_player.canMove(aim))
+    if (m_player.canMove(*this, aim))
     {
-        m_player.move(aim);
+        m_player.move(*this, aim);
         consume();
         return true;
     }
@@ -179,13 +196,13 @@ bool CGame::move(const JoyAim aim)
         Pos pushPos = translate(m_player.pos(), aim);
         if (pushChain(pushPos.x, pushPos.y, aim))
         {
-            m_player.move(aim);
+            m_player.move(*this, aim);
             return true;
         }
     }
     else if (def.type == TYPE_BARREL)
     {
-        const Pos pos = CGame::translate(m_player.pos(), aim);
+        const Pos pos = translate(m_player.pos(), aim);
         fuseBarrel(pos);
     }
     return false;
@@ -343,15 +360,28 @@ bool CGame::loadLevel(const GameMode mode)
     if (mode == MODE_CHUTE || mode == MODE_LEVEL_INTRO)
         m_usedItems.clear();
 
-    // extract level from MapArch
-    m_map = *(m_mapArch->at(m_level));
+    // extract level from MapArch, with its precomputed metadata if the
+    // editor saved some for this exact map
+    levelMeta_t meta;
+    const bool prefetched = m_prefetch && m_prefetch->take(m_level, m_map, meta);
+    const levelMeta_t *cached = nullptr;
+    if (!prefetched)
+    {
+        const CMap &level = *(m_mapArch->at(m_level));
+        m_map = level;
+        cached = m_mapArch->meta(level);
+        meta = cached ? *cached : buildLevelMeta(m_map);
+    }
 
     // remove used item
     for (const auto &pos : m_usedItems)
+    {
+        uncountTile(meta, pos);
         m_map.set(pos.x, pos.y, TILES_BLANK);
+    }
 
     if (!m_quiet)
-        LOGI("level loaded");
+        LOGI("level loaded%s", prefetched ? " (prefetched)" : cached ? " (precomputed)" : "");
 
     if (m_hints.size() == 0)
         LOGW("hints not loaded -- not available???");
@@ -368,54 +398,107 @@ bool CGame::loadLevel(const GameMode mode)
         pos = m_chuteTarget;
         if (!m_map.isValid(pos.x, pos.y))
         {
-            pos = m_map.findFirst(TILES_ANNIE2);
+            pos = meta.origin;
         }
         else
         {
             m_map.replaceTile(TILES_ANNIE2, TILES_BLANK);
+            uncountTile(meta, pos);
             m_map.set(pos.x, pos.y, TILES_ANNIE2);
         }
     }
     else if (origin != 0)
     {
         pos = CMap::toPos(origin);
+        uncountTile(meta, pos);
         m_map.set(pos.x, pos.y, TILES_ANNIE2);
     }
     else
     {
-        pos = m_map.findFirst(TILES_ANNIE2);
+        pos = meta.origin;
     }
     if (!m_quiet)
         LOGI("Player at: %d %d", pos.x, pos.y);
     m_player = std::move(CActor(pos, TYPE_PLAYER, AIM_DOWN));
-    m_diamonds = states.hasU(MAP_GOAL) ? states.getU(MAP_GOAL) : m_map.count(TILES_DIAMOND);
+    m_diamonds = states.hasU(MAP_GOAL) ? states.getU(MAP_GOAL) : meta.diamonds;
     resetKeys();
     m_health = DEFAULT_HEALTH;
-    spawnMonsters();
+    spawnMonsters(meta);
     m_sfx.clear();
     resetStats();
-    m_report = currentMapReport();
+    m_report = meta.report;
+
+    // stage the level that follows while this one is played
+    if (m_prefetch)
+        m_prefetch->request(m_mapArch, nextLevelIndex());
     return true;
 }
 
 /**
- * @brief Increase Level by 1. Wraps back to 0.
+ * @brief Take the tile about to be overwritten at pos out of the level
+ *        metadata, so that it keeps matching the current map
  *
+ * @param meta
+ * @param pos
  */
-void CGame::nextLevel()
+void CGame::uncountTile(levelMeta_t &meta, const Pos &pos) const
 {
-    addPoints(LEVEL_BONUS + m_health);
-    addPoints(m_map.states().getU(TIMEOUT) * 2);
-    if (m_level != static_cast<int>(m_mapArch->size()) - 1)
+    if (!m_map.isValid(pos.x, pos.y))
+        return;
+    const uint8_t tile = m_map.at(pos.x, pos.y);
+    const TileDef &def = getTileDef(tile);
+    if (tile == TILES_DIAMOND && meta.diamonds)
+        --meta.diamonds;
+    if (def.type == TYPE_PICKUP)
     {
-        ++m_level;
+        if (isFruit(tile))
+            --meta.report.fruits;
+        if (isBonusItem(tile))
+            --meta.report.bonuses;
     }
-    else
+    if (isMonsterType(def.type))
     {
-        m_level = 0;
+        auto &actors = meta.actors;
+        actors.erase(std::remove_if(actors.begin(), actors.end(), [&pos](const spawn_t &spawn)
+                                    { return spawn.pos == pos; }),
+                     actors.end());
     }
 }
 
+/**
+ * @brief Increase Level by 1. Wraps back to 0.
+ *
+ */
+void CGame::nextLevel()
+{
+    addPoints(LEVEL_BONUS + m_health);
+    addPoints(m_map.states().getU(TIMEOUT) * 2);
+    m_level = nextLevelIndex();
+}
+
+/**
+ * @brief Level that follows the current one. Wraps back to 0.
+ *
+ * @return int
+ */
+int CGame::nextLevelIndex() const
+{
+    return m_level != static_cast<int>(m_mapArch->size()) - 1 ? m_level + 1 : 0;
+}
+
+/**
+ * @brief Prepare the next level on a worker thread during play
+ *
+ * @param enable
+ */
+void CGame::setPrefetch(const bool enable)
+{
+    if (!enable)
+        m_prefetch.reset();
+    else if (!m_prefetch)
+        m_prefetch = std::make_unique<CLevelPrefetch>();
+}
+
 /**
  * @brief restarts level and clears player that are reset upon death
  *
@@ -472,6 +555,86 @@ void CGame::decTimers()
     }
 }
 
+/**
+ * @brief Advance the hurt stage that provides the invincibility frames.
+ *        Called every third tick by tick().
+ *
+ * @param healthRef health seen on the previous call, updated
+ * @return true when the player just got hurt
+ */
+bool CGame::manageHurt(int &healthRef)
+{
+    bool hurt = false;
+    if (health() < healthRef && m_gameStats->get(S_PLAYER_HURT) == HurtNone)
+    {
+        m_gameStats->set(S_PLAYER_HURT, HurtStart);
+        hurt = true;
+    }
+    if (health() >= healthRef)
+        m_gameStats->dec(S_PLAYER_HURT);
+    healthRef = health();
+    return hurt;
+}
+
+/**
+ * @brief Advance the session by one tick: timers, player, invincibility
+ *        frames, monsters and bosses. The front-end and the headless runner
+ *        both step through here, so a replay runs the same code as the game.
+ *        Resolving the closure (dying, next level) is left to the caller.
+ *
+ * @param ticks tick counter of the caller
+ * @param joyState JOY_AIMS entries, non-zero when pressed
+ * @param healthRef health seen on the previous hurt check, updated
+ * @return uint8_t TickFlag bits
+ */
+uint8_t CGame::tick(const int ticks, const uint8_t *joyState, int &healthRef)
+{
+    uint8_t flags = 0;
+    purgeSfx();
+    decTimers();
+    if (ticks % playerSpeed() == 0 && closusureTimer())
+    {
+        // decrease closure timer
+        decClosure();
+    }
+    else if (ticks % playerSpeed() == 0 &&
+             !isPlayerDead() &&
+             !isFrozen())
+    {
+        if (managePlayer(joyState) != AIM_NONE)
+        {
+            m_gameStats->set(S_IDLE_TIME, 0);
+        }
+        else
+        {
+            int &idleTime = m_gameStats->inc(S_IDLE_TIME);
+            if (idleTime >= MAX_IDLE_CYCLES)
+                idleTime = 0;
+        }
+    }
+
+    if (!isFrozen() && ticks % 3 == 0)
+    {
+        if (isClosure())
+            flags |= TICK_CLOSING;
+        else
+            flags |= manageHurt(healthRef) ? TICK_HURT : TICK_WALK;
+    }
+
+    manageMonsters(ticks);
+    manageBosses(ticks);
+    const uint16_t exitKey = m_map.states().getU(POS_EXIT);
+    if (isClosure())
+    {
+        flags |= TICK_CLOSURE;
+    }
+    else if (goalCount() == 0 && exitKey != 0)
+    {
+        checkClosure();
+    }
+    return flags;
+}
+
 /**
  * @brief reset player stats - called to clear stats when the level is loaded
  *
@@ -524,10 +687,12 @@ int CGame::level() const
  */
 void CGame::setMapArch(CMapArch *arch)
 {
+    if (m_prefetch)
+        m_prefetch->cancel();
     m_mapArch = arch;
 }
 
-bool CGame::isMonsterType(const uint8_t typeID) const
+bool CGame::isMonsterType(const uint8_t typeID)
 {
     std::array<uint8_t, 8> monsterTypes = {
         TYPE_MONSTER,
@@ -552,46 +717,36 @@ bool CGame::isMonsterType(const uint8_t typeID) const
  * @return true
  * @return false
  */
-bool CGame::spawnMonsters()
+bool CGame::spawnMonsters(const levelMeta_t &meta)
 {
     m_monsters.clear();
     m_bosses.clear();
-    for (int y = 0; y < m_map.hei(); ++y)
+    for (const auto &spawn : meta.actors)
     {
-        for (int x = 0; x < m_map.len(); ++x)
-        {
-            uint8_t c = m_map.at(x, y);
-            const TileDef &def = getTileDef(c);
-            if (isMonsterType(def.type))
-            {
-                if (isPushable(def.type))
-                    m_monsters.emplace_back(std::move(CActor(x, y, def.type, JoyAim::AIM_NONE)));
-                else
-                    m_monsters.emplace_back(std::move(CActor(x, y, def.type)));
-            }
-        }
+        if (isPushable(spawn.type))
+            m_monsters.emplace_back(std::move(CActor(spawn.pos, spawn.type, JoyAim::AIM_NONE)));
+        else
+            m_monsters.emplace_back(std::move(CActor(spawn.pos.x, spawn.pos.y, spawn.type)));
     }
 
     std::vector<Pos> removed;
-    for (const auto &[key, attr] : m_map.attrs())
+    for (const auto &[pos, attr] : meta.attrSpawns)
     {
         if (RANGE(attr, ATTR_CRUSHER_MIN, ATTR_CRUSHER_MAX))
         {
-            const Pos &pos = CMap::toPos(key);
             const JoyAim aim = attr < ATTR_CRUSHERH_MIN ? AIM_UP : AIM_LEFT;
             m_monsters.emplace_back(std::move(CActor(pos, attr, aim)));
             removed.emplace_back(pos);
         }
         else if (RANGE(attr, ATTR_BOSS_MIN, ATTR_BOSS_MAX))
         {
-            const Pos &pos = CMap::toPos(key);
             const bossData_t *bossData = getBossData(attr);
             if (bossData)
             {
                 CBoss boss(
                     static_cast<int16_t>(pos.x) * CBoss::BOSS_GRANULAR_FACTOR,
                     static_cast<int16_t>(pos.y) * CBoss::BOSS_GRANULAR_FACTOR,
-                    bossData);
+                    bossData, skill());
                 LOGI("boss 0x%.2x speed=%d", attr, bossData->speed);
                 m_bosses.emplace_back(std::move(boss));
             }
@@ -674,7 +829,7 @@ uint8_t CGame::managePlayer(const uint8_t *joystate)
  * @param aim direct UP,DOWN,LEFT or RIGHT
  * @return Pos new position
  */
-Pos CGame::translate(const Pos &p, const int aim)
+Pos CGame::translate(const Pos &p, const int aim) const
 {
     Pos t = p;
 
@@ -715,7 +870,7 @@ Pos CGame::translate(const Pos &p, const int aim)
  * @return true
  * @return false
  */
-bool CGame::hasKey(const uint8_t c)
+bool CGame::hasKey(const uint8_t c) const
 {
     for (uint32_t i = 0; i < MAX_KEYS; ++i)
     {
@@ -1076,7 +1231,7 @@ bool CGame::validateSignature(const char *signature, const uint32_t version)
         LOGW("savefile signature mismatch: `%s` -- expecting `%s`", signature, gameSig);
         return false;
     }
-    if (version != ENGINE_VERSION)
+    if (version != ENGINE_VERSION && version != FULLMAP_ENGINE_VERSION)
     {
         LOGW("savegame version mismatched: 0x%.8x -- expecting 0x%.8x", version, ENGINE_VERSION);
         return false;
@@ -1085,7 +1240,8 @@ bool CGame::validateSignature(const char *signature, const uint32_t version)
 }
 
 /**
- * @brief Deserializes the game state from disk
+ * @brief Deserializes the game state from disk.
+ *        Both the compact format and the older full map format are accepted.
  *
  * @param sfile file handle
  * @return true
@@ -1110,6 +1266,107 @@ bool CGame::read(IFile &sfile)
     uint32_t indexPtr = 0;
     _R(&indexPtr, sizeof(indexPtr));
 
+    if (version == FULLMAP_ENGINE_VERSION)
+        return readBody(sfile, false);
+
+    // compact save: packed body
+    uint32_t rawSize = 0;
+    uint32_t packedSize = 0;
+    _R(&rawSize, sizeof(rawSize));
+    _R(&packedSize, sizeof(packedSize));
+    if (rawSize > MAX_SAVE_BODY || packedSize > compressBound(rawSize))
+    {
+        LOGE("savegame body size out of range: %u (packed: %u)", rawSize, packedSize);
+        return false;
+    }
+    std::vector<uint8_t> raw(rawSize);
+    if (packedSize == 0)
+    {
+        // stored
+        _R(raw.data(), rawSize);
+    }
+    else
+    {
+        std::vector<uint8_t> packed(packedSize);
+        _R(packed.data(), packedSize);
+        uLongf destLen = rawSize;
+        const int err = uncompress(raw.data(), &destLen, packed.data(), packedSize);
+        if (err != Z_OK || destLen != rawSize)
+        {
+            LOGE("failed to unpack savegame: %s", zError(err));
+            return false;
+        }
+    }
+
+    CFileMem mem;
+    mem.open("", "rb");
+    mem.replace(raw.data(), raw.size());
+    return readBody(mem, true);
+}
+
+/**
+ * @brief Serializes the game state to disk.
+ *        The map is stored as its differences with the archive level.
+ *
+ * @param tfile file handle
+ * @param pack deflate the body
+ * @return true
+ * @return false
+ */
+bool CGame::write(IFile &tfile, const bool pack)
+{
+    auto writefile = [&tfile](auto ptr, auto size)
+    {
+        return tfile.write(ptr, size) == 1;
+    };
+
+    // writing signature/version
+    _W(&GAME_SIGNATURE, sizeof(GAME_SIGNATURE));
+    uint32_t version = ENGINE_VERSION;
+    _W(&version, sizeof(version));
+
+    // ptr
+    uint32_t indexPtr = 0;
+    _W(&indexPtr, sizeof(indexPtr));
+
+    CFileMem mem;
+    mem.open("", "wb");
+    if (!writeBody(mem))
+        return false;
+    const std::vector<uint8_t> &raw = mem.buffer();
+    const uint32_t rawSize = raw.size();
+    uint32_t packedSize = 0;
+    std::vector<uint8_t> packed;
+    if (pack)
+    {
+        const int err = compressData(raw, packed);
+        if (err != Z_OK)
+        {
+            LOGE("failed to pack savegame: %s", zError(err));
+            return false;
+        }
+        packedSize = packed.size();
+    }
+    _W(&rawSize, sizeof(rawSize));
+    _W(&packedSize, sizeof(packedSize));
+    if (pack)
+    {
+        _W(packed.data(), packedSize);
+    }
+    else
+    {
+        _W(raw.data(), rawSize);
+    }
+    return true;
+}
+
+bool CGame::readBody(IFile &sfile, const bool compact, const std::vector<uint8_t> *tiles)
+{
+    auto readfile = [&sfile](auto ptr, auto size)
+    {
+        return sfile.read(ptr, size) == 1;
+    };
+
     // general information
     _R(&m_lives, sizeof(m_lives));
     _R(&m_health, sizeof(m_health));
@@ -1131,8 +1388,7 @@ bool CGame::read(IFile &sfile)
     };
 
     // reading map
-    CMap &map = getMap();
-    if (!map.read(sfile))
+    if (tiles ? !readMapPlane(sfile, *tiles) : compact ? !readMapDelta(sfile) : !m_map.read(sfile))
     {
         LOGE("failed to read map");
         return false;
@@ -1195,30 +1451,13 @@ bool CGame::read(IFile &sfile)
     return true;
 }
 
-/**
- * @brief Serializes the game state from disk
- *
- * @param sfile file handle
- * @return true
- * @return false
- */
-
-bool CGame::write(IFile &tfile)
+bool CGame::writeBody(IFile &tfile, std::vector<uint8_t> *tiles)
 {
     auto writefile = [&tfile](auto ptr, auto size)
     {
         return tfile.write(ptr, size) == 1;
     };
 
-    // writing signature/version
-    _W(&GAME_SIGNATURE, sizeof(GAME_SIGNATURE));
-    uint32_t version = ENGINE_VERSION;
-    _W(&version, sizeof(version));
-
-    // ptr
-    uint32_t indexPtr = 0;
-    _W(&indexPtr, sizeof(indexPtr));
-
     // write general information
     _W(&m_lives, sizeof(m_lives));
     _W(&m_health, sizeof(m_health));
@@ -1239,8 +1478,7 @@ bool CGame::write(IFile &tfile)
     }
 
     // saving map
-    CMap &map = getMap();
-    if (!map.write(tfile))
+    if (tiles ? !writeMapPlane(tfile, *tiles) : !writeMapDelta(tfile))
     {
         LOGE("failed to write map");
         return false;
@@ -1285,6 +1523,245 @@ bool CGame::write(IFile &tfile)
     return true;
 }
 
+/**
+ * @brief Capture the session for the rewind buffer: the tiles are copied
+ *        as is, everything else is serialized. Unlike write(), nothing is
+ *        compared with the archive level, so it's cheap enough for every tick.
+ *
+ * @param tfile receives the session without the tiles
+ * @param tiles receives the tiles
+ * @return true
+ * @return false
+ */
+bool CGame::writeSnapshot(IFile &tfile, std::vector<uint8_t> &tiles)
+{
+    return writeBody(tfile, &tiles);
+}
+
+/**
+ * @brief Restore a session captured by writeSnapshot() on the current level.
+ *        The snapshot is read into a scratch session first: one that doesn't
+ *        read back in full leaves this session untouched.
+ *
+ * @param sfile
+ * @param tiles
+ * @return true
+ * @return false
+ */
+bool CGame::readSnapshot(IFile &sfile, const std::vector<uint8_t> &tiles)
+{
+    const long start = sfile.tell();
+    CGame scratch;
+    scratch.m_map = m_map;
+    if (!scratch.readBody(sfile, true, &tiles))
+        return false;
+    sfile.seek(start);
+    return readBody(sfile, true, &tiles);
+}
+
+/**
+ * @brief Write the map as the tiles and attributes that differ from the
+ *        archive level, followed by the states. The whole map is written
+ *        instead when the archive level isn't available.
+ *
+ * @param tfile
+ * @return true
+ * @return false
+ */
+bool CGame::writeMapDelta(IFile &tfile)
+{
+    auto writefile = [&tfile](auto ptr, auto size)
+    {
+        return tfile.write(ptr, size) == 1;
+    };
+
+    CMap &map = m_map;
+    CMap *base = m_mapArch ? m_mapArch->at(m_level) : nullptr;
+    uint8_t mode = base && base->len() == map.len() && base->hei() == map.hei()
+                       ? SAVEMAP_DELTA
+                       : SAVEMAP_FULL;
+    _W(&mode, sizeof(mode));
+    if (mode == SAVEMAP_FULL)
+        return map.write(tfile);
+
+    const uint32_t crc = base->crc();
+    _W(&crc, sizeof(crc));
+
+    // tiles
+    std::vector<uint8_t> tiles;
+    for (int y = 0; y < map.hei(); ++y)
+    {
+        for (int x = 0; x < map.len(); ++x)
+        {
+            const uint8_t tile = map.at(x, y);
+            if (tile == base->at(x, y))
+                continue;
+            const uint16_t key = CMap::toKey(x, y);
+            tiles.insert(tiles.end(), {static_cast<uint8_t>(key), static_cast<uint8_t>(key >> 8), tile});
+        }
+    }
+    uint32_t count = tiles.size() / DELTA_ENTRY_SIZE;
+    _W(&count, sizeof(count));
+    if (count)
+        _W(tiles.data(), tiles.size());
+
+    // attributes, a zero clears the base attribute
+    std::vector<uint8_t> attrs;
+    auto addAttr = [&attrs](const uint16_t key, const uint8_t a)
+    {
+        attrs.insert(attrs.end(), {static_cast<uint8_t>(key), static_cast<uint8_t>(key >> 8), a});
+    };
+    for (const auto &[key, a] : map.attrs())
+    {
+        const Pos pos = CMap::toPos(key);
+        if (base->getAttr(pos.x, pos.y) != a)
+            addAttr(key, a);
+    }
+    for (const auto &[key, a] : base->attrs())
+    {
+        const Pos pos = CMap::toPos(key);
+        if (map.getAttr(pos.x, pos.y) == 0)
+            addAttr(key, 0);
+    }
+    count = attrs.size() / DELTA_ENTRY_SIZE;
+    _W(&count, sizeof(count));
+    if (count)
+        _W(attrs.data(), attrs.size());
+
+    return map.statesConst().write(tfile);
+}
+
+bool CGame::readMapDelta(IFile &sfile)
+{
+    auto readfile = [&sfile](auto ptr, auto size)
+    {
+        return sfile.read(ptr, size) == 1;
+    };
+
+    uint8_t mode = 0;
+    _R(&mode, sizeof(mode));
+    if (mode == SAVEMAP_FULL)
+        return m_map.read(sfile);
+    if (mode != SAVEMAP_DELTA)
+    {
+        LOGE("unknown map storage: %u", mode);
+        return false;
+    }
+
+    CMap *base = m_mapArch ? m_mapArch->at(m_level) : nullptr;
+    if (base == nullptr)
+    {
+        LOGE("savegame level %d not found in archive", m_level + 1);
+        return false;
+    }
+    uint32_t crc = 0;
+    _R(&crc, sizeof(crc));
+    if (crc != base->crc())
+    {
+        LOGE("savegame was made for a different version of level %d", m_level + 1);
+        return false;
+    }
+
+    CMap &map = m_map;
+    map = *base;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        uint32_t count = 0;
+        _R(&count, sizeof(count));
+        if (count > map.size())
+        {
+            LOGE("too many map delta entries: %u", count);
+            return false;
+        }
+        std::vector<uint8_t> entries(count * DELTA_ENTRY_SIZE);
+        if (count)
+            _R(entries.data(), entries.size());
+        for (size_t i = 0; i < entries.size(); i += DELTA_ENTRY_SIZE)
+        {
+            const Pos pos = CMap::toPos(entries[i] | (entries[i + 1] << 8));
+            if (!map.isValid(pos.x, pos.y))
+            {
+                LOGE("map delta out of bound: %d,%d", pos.x, pos.y);
+                return false;
+            }
+            if (pass == 0)
+                map.set(pos.x, pos.y, entries[i + 2]);
+            else
+                map.setAttr(pos.x, pos.y, entries[i + 2]);
+        }
+    }
+    return map.states().read(sfile);
+}
+
+bool CGame::writeMapPlane(IFile &tfile, std::vector<uint8_t> &tiles)
+{
+    auto writefile = [&tfile](auto ptr, auto size)
+    {
+        return tfile.write(ptr, size) == 1;
+    };
+
+    const uint8_t mode = SAVEMAP_PLANE;
+    _W(&mode, sizeof(mode));
+    m_map.copyTiles(tiles);
+
+    std::vector<uint8_t> attrs;
+    attrs.reserve(m_map.attrs().size() * DELTA_ENTRY_SIZE);
+    for (const auto &[key, a] : m_map.attrs())
+        attrs.insert(attrs.end(), {static_cast<uint8_t>(key), static_cast<uint8_t>(key >> 8), a});
+    const uint32_t count = attrs.size() / DELTA_ENTRY_SIZE;
+    _W(&count, sizeof(count));
+    if (count)
+        _W(attrs.data(), attrs.size());
+
+    return m_map.statesConst().write(tfile);
+}
+
+bool CGame::readMapPlane(IFile &sfile, const std::vector<uint8_t> &tiles)
+{
+    auto readfile = [&sfile](auto ptr, auto size)
+    {
+        return sfile.read(ptr, size) == 1;
+    };
+
+    uint8_t mode = 0;
+    _R(&mode, sizeof(mode));
+    if (mode != SAVEMAP_PLANE || !m_map.setTiles(tiles))
+    {
+        LOGE("snapshot doesn't match the current map");
+        return false;
+    }
+
+    uint32_t count = 0;
+    _R(&count, sizeof(count));
+    if (count > m_map.size())
+    {
+        LOGE("too many attributes in snapshot: %u", count);
+        return false;
+    }
+    std::vector<uint8_t> entries(count * DELTA_ENTRY_SIZE);
+    if (count)
+        _R(entries.data(), entries.size());
+    std::vector<uint16_t> stale;
+    for (const auto &[key, a] : m_map.attrs())
+        stale.emplace_back(key);
+    for (const uint16_t key : stale)
+    {
+        const Pos pos = CMap::toPos(key);
+        m_map.setAttr(pos.x, pos.y, 0);
+    }
+    for (size_t i = 0; i < entries.size(); i += DELTA_ENTRY_SIZE)
+    {
+        const Pos pos = CMap::toPos(entries[i] | (entries[i + 1] << 8));
+        if (!m_map.isValid(pos.x, pos.y))
+        {
+            LOGE("snapshot attribute out of bound: %d,%d", pos.x, pos.y);
+            return false;
+        }
+        m_map.setAttr(pos.x, pos.y, entries[i + 2]);
+    }
+    return m_map.states().read(sfile);
+}
+
 /**
  * @brief set lives count for the player
  *
@@ -1477,19 +1954,22 @@ MapReport CGame::currentMapReport()
 
 MapReport CGame::generateMapReport(CMap &map)
 {
-    MapReport report;
-    std::unordered_map<uint8_t, int> tiles;
-    for (int y = 0; y < map.hei(); ++y)
-    {
-        for (int x = 0; x < map.len(); ++x)
-        {
-            const auto &tile = map.at(x, y);
-            tiles[tile] += 1;
-        }
-    }
+    tileUsage_t usage;
+    countTiles(map, usage);
+    return generateMapReport(usage, map.attrs());
+}
 
+/**
+ * @brief Generate the report from tile counts already taken
+ *
+ * @param usage cells per tile
+ * @param attrs map attributes
+ * @return MapReport
+ */
+MapReport CGame::generateMapReport(const tileUsage_t &usage, const attrMap_t &attrs)
+{
+    MapReport report;
     std::unordered_map<uint8_t, int> secrets;
-    const attrMap_t &attrs = map.attrs();
     for (const auto &[k, v] : attrs)
     {
         if (RANGE(v, SECRET_ATTR_MIN, SECRET_ATTR_MAX))
@@ -1498,10 +1978,10 @@ MapReport CGame::generateMapReport(CMap &map)
     report.bonuses = 0;
     report.fruits = 0;
     report.secrets = secrets.size();
-    for (const auto [tile, count] : tiles)
+    for (size_t tile = 0; tile < usage.size(); ++tile)
     {
-        const TileDef &def = getTileDef(tile);
-        if (def.type != TYPE_PICKUP)
+        const uint32_t count = usage[tile];
+        if (count == 0 || getTileDef(tile).type != TYPE_PICKUP)
             continue;
         if (isFruit(tile))
             report.fruits += count;
@@ -1511,6 +1991,60 @@ MapReport CGame::generateMapReport(CMap &map)
     return report;
 }
 
+/**
+ * @brief Count the cells using each tile
+ *
+ * @param map
+ * @param usage
+ */
+void CGame::countTiles(const CMap &map, tileUsage_t &usage)
+{
+    usage.fill(0);
+    for (int y = 0; y < map.hei(); ++y)
+    {
+        for (int x = 0; x < map.len(); ++x)
+            ++usage[map.at(x, y)];
+    }
+}
+
+/**
+ * @brief Scan a map for everything loadLevel() needs: player origin,
+ *        diamonds, monster spawns and the map report
+ *
+ * @param map
+ * @return levelMeta_t
+ */
+levelMeta_t CGame::buildLevelMeta(CMap &map)
+{
+    levelMeta_t meta;
+    meta.origin = map.findFirst(TILES_ANNIE2);
+    for (int y = 0; y < map.hei(); ++y)
+    {
+        for (int x = 0; x < map.len(); ++x)
+        {
+            const uint8_t tile = map.at(x, y);
+            if (tile == TILES_DIAMOND)
+                ++meta.diamonds;
+            const TileDef &def = getTileDef(tile);
+            if (isMonsterType(def.type))
+                meta.actors.emplace_back(spawn_t{Pos{static_cast<int16_t>(x), static_cast<int16_t>(y)}, def.type});
+        }
+    }
+
+    for (const auto &[key, attr] : map.attrs())
+    {
+        if (RANGE(attr, ATTR_CRUSHER_MIN, ATTR_CRUSHER_MAX) ||
+            RANGE(attr, ATTR_BOSS_MIN, ATTR_BOSS_MAX))
+            meta.attrSpawns.emplace_back(spawn_t{CMap::toPos(key), attr});
+    }
+    // the attribute hash has no stable order
+    std::sort(meta.attrSpawns.begin(), meta.attrSpawns.end(), [](const spawn_t &a, const spawn_t &b)
+              { return CMap::toKey(a.pos) < CMap::toKey(b.pos); });
+
+    meta.report = generateMapReport(map);
+    return meta;
+}
+
 /**
  * @brief Get Special effects List
  *
@@ -1714,9 +2248,14 @@ void CGame::deleteMonster(const int i)
     rebuildMonsterGrid();
 }
 
+/**
+ * @brief returns the rng of the default session
+ *
+ * @return Random&
+ */
 Random &CGame::getRandom()
 {
-    return g_randomz;
+    return getGame()->m_rng;
 }
 
 bool CGame::isBulletType(const uint8_t typeID)
@@ -1745,11 +2284,11 @@ bool CGame::shadowActorMove(CActor &actor, const JoyAim aim)
         m_monsterGrid.erase(it);
     }
 
-    const Pos newPos = CGame::translate(actor.pos(), aim);
+    const Pos newPos = translate(actor.pos(), aim);
     if (monsterIndex != INVALID && m_map.isValid(newPos.x, newPos.y))
     {
         m_monsterGrid[CMap::toKey(newPos.x, newPos.y)] = monsterIndex;
-        actor.move(aim);
+        actor.move(*this, aim);
         return true;
     }
     return false;
@@ -1771,4 +2310,44 @@ void CGame::updateMonsterGrid(const CActor &actor, const int monsterIndex)
     const Pos pos = actor.pos();
     if (monsterIndex != INVALID && m_map.isValid(pos.x, pos.y))
         m_monsterGrid[CMap::toKey(pos.x, pos.y)] = monsterIndex;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Hash the session state, one value per subsystem.
+ *        Map tiles and attributes are maintained incrementally by CMap;
+ *        actors, bosses, stats and rng are small and hashed on demand.
+ *
+ * @return stateHash_t
+ */
+stateHash_t CGame::stateHash() const
+{
+    auto hashActor = [](uint64_t h, const CActor &actor)
+    {
+        h = StateHash::combine(h, (static_cast<uint64_t>(actor.x()) << 48) |
+                                      (static_cast<uint64_t>(actor.y()) << 32) |
+                                      (actor.type() << 16) | (actor.getAim() << 8) | actor.getPU());
+        return StateHash::combine(h, static_cast<uint32_t>(actor.getTTL()));
+    };
+
+    stateHash_t hash;
+    hash.parts[stateHash_t::TILES] = m_map.tileHash();
+    hash.parts[stateHash_t::ATTRS] = m_map.attrHash();
+    uint64_t h = hashActor(0, m_player);
+    for (const auto &actor : m_monsters)
+        h = hashActor(h, actor);
+    hash.parts[stateHash_t::ACTORS] = StateHash::combine(h, m_monsters.size());
+    h = 0;
+    for (const auto &boss : m_bosses)
+    {
+        h = StateHash::combine(h, (static_cast<uint64_t>(static_cast<uint16_t>(boss.x())) << 48) |
+                                      (static_cast<uint64_t>(static_cast<uint16_t>(boss.y())) << 32) |
+                                      (boss.state() << 8) | boss.getAim());
+        h = StateHash::combine(h, static_cast<uint32_t>(boss.hp()));
+    }
+    hash.parts[stateHash_t::BOSSES] = StateHash::combine(h, m_bosses.size());
+    hash.parts[stateHash_t::STATS] = StateHash::combine(m_gameStats->hash(),
+                                                        (static_cast<uint64_t>(static_cast<uint32_t>(m_score)) << 32) |
+                                                            (static_cast<uint32_t>(m_health) << 8) | static_cast<uint8_t>(m_lives));
+    hash.parts[stateHash_t::RNG] = m_rng.state();
+    return hash;
+}
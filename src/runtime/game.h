@@ -25,25 +25,21 @@
 #include "actor.h"
 #include "map.h"
 #include "events.h"
+#include "randomz.h"
+#include "statehash.h"
+#include "levelmeta.h"
 
 class CGameStats;
 class CMapArch;
 class ISound;
 class CBoss;
-class Random;
+class CLevelPrefetch;
 class IFile;
 struct TileDef;
 enum Event;
 enum Sfx : uint16_t;
 struct sfx_t;
 
-struct MapReport
-{
-    int fruits;
-    int bonuses;
-    int secrets;
-};
-
 struct bulletData_t
 {
     uint8_t sound;
@@ -51,6 +47,18 @@ struct bulletData_t
     uint16_t sfxTimeOut;
 };
 
+struct blast_t
+{
+    Pos pos;
+    int radius;
+    int damage;
+};
+
+/**
+ * @brief Game session. Owns the map, keys, rng, monsters and stats of one
+ * simulation; several instances can run side by side. getGame() returns a
+ * process-wide default session for the front-ends.
+ */
 class CGame
 {
 public:
@@ -82,6 +90,11 @@ public:
         MAX_KEY_STATE = 5,
     };
 
+    enum : int32_t
+    {
+        MAX_IDLE_CYCLES = 0x100,
+    };
+
     enum Hurt
     {
         HurtNone,
@@ -91,25 +104,38 @@ public:
         HurtStart = HurtFlash
     };
 
+    enum TickFlag : uint8_t
+    {
+        TICK_WALK = 1,    // hurt beat: the player is free to walk
+        TICK_HURT = 2,    // hurt beat: the player just got hurt
+        TICK_CLOSING = 4, // hurt beat during the level closure
+        TICK_CLOSURE = 8, // closure in progress, resolved by the caller
+    };
+
     struct userKeys_t
     {
         uint8_t tiles[MAX_KEYS];
         uint8_t indicators[MAX_KEYS];
     };
 
+    CGame();
     ~CGame();
     bool loadLevel(const GameMode mode);
     bool move(const JoyAim dir);
     void manageMonsters(const int ticks);
     void manageBosses(const int ticks);
     uint8_t managePlayer(const uint8_t *joystate);
-    static Pos translate(const Pos &p, const int aim);
+    Pos translate(const Pos &p, const int aim) const;
     void consume();
-    static bool hasKey(const uint8_t c);
+    bool hasKey(const uint8_t c) const;
     void addKey(const uint8_t c);
     int goalCount() const;
+    inline CMap &map() { return m_map; }
+    inline const CMap &map() const { return m_map; }
     static CMap &getMap();
     void nextLevel();
+    int nextLevelIndex() const;
+    void setPrefetch(const bool enable);
     void restartLevel();
     void restartGame();
     void setMode(const GameMode mode);
@@ -130,7 +156,7 @@ public:
     bool isGodMode() const;
     bool isRageMode() const;
     int playerSpeed() const;
-    static userKeys_t &keys();
+    userKeys_t &keys();
     std::vector<CActor> &getMonsters();
     CActor &getMonster(int i);
     std::vector<sfx_t> &getSfx();
@@ -143,6 +169,8 @@ public:
     int size() const;
     void resetStats();
     void decTimers();
+    bool manageHurt(int &healthRef);
+    uint8_t tick(const int ticks, const uint8_t *joyState, int &healthRef);
     void parseHints(const char *data);
     int getEvent();
     void purgeSfx();
@@ -158,6 +186,9 @@ public:
     int getUserID() const;
     void setUserID(const int userID) const;
     static MapReport generateMapReport(CMap &map);
+    static MapReport generateMapReport(const tileUsage_t &usage, const attrMap_t &attrs);
+    static void countTiles(const CMap &map, tileUsage_t &usage);
+    static levelMeta_t buildLevelMeta(CMap &map);
     MapReport currentMapReport();
     const MapReport &originalMapReport();
     int timeTaken();
@@ -167,13 +198,16 @@ public:
     int defaultLives();
     void setDefaultLives(int lives);
     bool read(IFile &sfile);
-    bool write(IFile &tfile);
+    bool write(IFile &tfile, const bool pack = true);
+    bool readSnapshot(IFile &sfile, const std::vector<uint8_t> &tiles);
+    bool writeSnapshot(IFile &tfile, std::vector<uint8_t> &tiles);
     const std::vector<CBoss> &bosses();
     int findMonsterAt(const int x, const int y) const;
     void deleteMonster(const int i);
+    inline Random &rng() { return m_rng; }
     static Random &getRandom();
     static bool validateSignature(const char *signature, const uint32_t version);
-    bool isMonsterType(const uint8_t typeID) const;
+    static bool isMonsterType(const uint8_t typeID);
     static bool isFruit(const uint8_t tileID);
     static bool isBonusItem(const uint8_t tileID);
     static bool isBulletType(const uint8_t typeID);
@@ -182,6 +216,7 @@ public:
     static bool isPushable(const uint8_t typeID);
 
     bool shadowActorMove(CActor &actor, const JoyAim aim);
+    stateHash_t stateHash() const;
 
     enum
     {
@@ -196,7 +231,7 @@ private:
     int m_score = 0;
     int m_nextLife;
     int m_diamonds = 0;
-    inline static userKeys_t m_keys;
+    userKeys_t m_keys;
     GameMode m_mode;
     int m_introHint = 0;
     std::vector<Event> m_events;
@@ -208,8 +243,13 @@ private:
     std::shared_ptr<ISound> m_sound;
     std::vector<std::string> m_hints;
     std::unique_ptr<CGameStats> m_gameStats;
+    std::unique_ptr<CLevelPrefetch> m_prefetch;
     std::vector<Pos> m_usedItems;
     std::unordered_map<uint16_t, int> m_monsterGrid;
+    std::vector<blast_t> m_blasts;
+    std::vector<uint8_t> m_blastVisited;
+    std::vector<int> m_blastDamage;
+    std::vector<uint32_t> m_blastCells;
     MapReport m_report;
     int m_defaultLives;
     bool m_quiet = false;
@@ -218,10 +258,16 @@ private:
     void setQuiet(bool state);
     void rebuildMonsterGrid();
     void updateMonsterGrid(const CActor &actor, const int index);
+    bool readBody(IFile &sfile, const bool compact, const std::vector<uint8_t> *tiles = nullptr);
+    bool writeBody(IFile &tfile, std::vector<uint8_t> *tiles = nullptr);
+    bool readMapDelta(IFile &sfile);
+    bool writeMapDelta(IFile &tfile);
+    bool readMapPlane(IFile &sfile, const std::vector<uint8_t> &tiles);
+    bool writeMapPlane(IFile &tfile, std::vector<uint8_t> &tiles);
 
-    CGame();
     int clearAttr(const uint8_t attr);
-    bool spawnMonsters();
+    bool spawnMonsters(const levelMeta_t &meta);
+    void uncountTile(levelMeta_t &meta, const Pos &pos) const;
     void addHealth(const int hp);
     void addPoints(const int points);
     void addLife();
@@ -240,7 +286,8 @@ private:
     void handleBarrel(CActor &actor, const TileDef &def, const int i, std::set<int, std::greater<int>> &deletedMonsters);
     bool pushChain(const int x, const int y, const JoyAim aim);
     bool fuseBarrel(const Pos &pos);
-    void blastRadius(const Pos &pos, const size_t radius, const int damage, std::set<int, std::greater<int>> &deletedMonsters);
+    void blastRadius(const Pos &pos, const int radius, const int damage);
+    void resolveBlasts(std::set<int, std::greater<int>> &deletedMonsters);
 
     // boss
     CActor *spawnBullet(int x, int y, JoyAim aim, uint8_t tile);
@@ -248,6 +295,10 @@ private:
     bool handleBossBullet(CBoss &boss);
     void handleBossHitboxContact(CBoss &boss);
 
-    inline static CMap m_map;
+    CMap m_map;
+    Random m_rng{12345, 0};
     friend class CGameMixin;
+    friend class CSimRunner;
 };
+
+using GameSession = CGame;
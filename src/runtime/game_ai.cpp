@@ -93,25 +93,25 @@ void CGame::handleBossPath(CBoss &boss)
     {
         auto pathAI = CPath::getPathAlgo(algo);
         if (pathAI)
-            boss.followPath(playerPos, *pathAI);
+            boss.followPath(*this, playerPos, *pathAI);
     }
 
     // Fallback movement
-    if (bx < player.x() && boss.canMove(JoyAim::AIM_RIGHT))
+    if (bx < player.x() && boss.canMove(*this, JoyAim::AIM_RIGHT))
     {
-        boss.move(JoyAim::AIM_RIGHT);
+        boss.move(*this, JoyAim::AIM_RIGHT);
     }
-    else if (bx > player.x() && boss.canMove(JoyAim::AIM_LEFT))
+    else if (bx > player.x() && boss.canMove(*this, JoyAim::AIM_LEFT))
     {
-        boss.move(JoyAim::AIM_LEFT);
+        boss.move(*this, JoyAim::AIM_LEFT);
     }
-    else if (by < player.y() && boss.canMove(JoyAim::AIM_DOWN))
+    else if (by < player.y() && boss.canMove(*this, JoyAim::AIM_DOWN))
     {
-        boss.move(JoyAim::AIM_DOWN);
+        boss.move(*this, JoyAim::AIM_DOWN);
     }
-    else if (by > player.y() && boss.canMove(JoyAim::AIM_UP))
+    else if (by > player.y() && boss.canMove(*this, JoyAim::AIM_UP))
     {
-        boss.move(JoyAim::AIM_UP);
+        boss.move(*this, JoyAim::AIM_UP);
     }
 }
 
@@ -146,7 +146,7 @@ bool CGame::handleBossBullet(CBoss &boss)
         boss.setState(CBoss::BossState::Attack);
         playSound(boss.data()->attack_sound);
         if (boss.data()->bullet_algo != BossData::Path::NONE)
-            bullet->startPath(m_player.pos(), boss.data()->bullet_algo, boss.data()->bullet_ttl);
+            bullet->startPath(*this, m_player.pos(), boss.data()->bullet_algo, boss.data()->bullet_ttl);
 
         return true;
     }
@@ -158,7 +158,7 @@ void CGame::handleBossHitboxContact(CBoss &boss)
     int playerDamage = 0;
 
     //  Attack hitbox: Affect all player tiles it overlaps
-    boss.testHitbox1(m_map, [](const Pos &p, auto type)
+    boss.testHitbox1(m_map, [this](const Pos &p, auto type)
                      {
                          (void)type;
                          return m_map.at(p.x, p.y) == TILES_ANNIE2; // check if player is there
@@ -174,11 +174,10 @@ void CGame::handleBossHitboxContact(CBoss &boss)
     const uint32_t boss_flags = boss.data()->flags;
     if (boss_flags & BOSS_FLAG_ICE_DAMAGE)
     {
-        boss.testHitbox1(m_map, [](const Pos &pos, auto type)
+        boss.testHitbox1(m_map, [this](const Pos &pos, auto type)
                          {
                              (void)type;
-                             const CMap &map = CGame::getMap();
-                             const auto c = map.at(pos.x, pos.y);
+                             const auto c = m_map.at(pos.x, pos.y);
                              const TileDef &def = getTileDef(c);
                              return def.type == TYPE_ICECUBE; // check if IceCube
                          },
@@ -194,25 +193,22 @@ void CGame::handleBossHitboxContact(CBoss &boss)
                              }
 
                              // meltIceCube
-                             CGame *game = CGame::getGame();
-                             CMap &map = CGame::getMap();
-                             int i = game->findMonsterAt(pos.x, pos.y);
-                             if (i != CGame::INVALID)
+                             int i = findMonsterAt(pos.x, pos.y);
+                             if (i != INVALID)
                              {
-                                 game->deleteMonster(i);
-                                 game->getSfx().emplace_back(sfx_t{pos.x, pos.y, SFX_EXPLOSION6, SFX_EXPLOSION6_TIMEOUT});
-                                 map.set(pos.x, pos.y, TILES_BLANK);
+                                 deleteMonster(i);
+                                 m_sfx.emplace_back(sfx_t{pos.x, pos.y, SFX_EXPLOSION6, SFX_EXPLOSION6_TIMEOUT});
+                                 m_map.set(pos.x, pos.y, TILES_BLANK);
                              } //
                          });
     }
 
     // test if boss has set off barrel
-    boss.testHitbox1(m_map, [](const Pos &pos, auto type)
+    boss.testHitbox1(m_map, [this](const Pos &pos, auto type)
                      {
                          if (type != BossData::HitBoxType::SPECIAL1)
                              return false;
-                         const CMap &map = CGame::getMap();
-                         const auto c = map.at(pos.x, pos.y);
+                         const auto c = m_map.at(pos.x, pos.y);
                          const TileDef &def = getTileDef(c);
                          return def.type == TYPE_BARREL; // check if barrel
                      },
@@ -224,7 +220,7 @@ void CGame::handleBossHitboxContact(CBoss &boss)
 
 void CGame::manageBosses(const int ticks)
 {
-    auto &rng = getRandom();
+    Random &rng = m_rng;
     rng.setTick(ticks);
 
     const CActor &player = m_player;
@@ -254,7 +250,7 @@ void CGame::manageBosses(const int ticks)
 
         if (boss.state() == CBoss::BossState::Patrol)
         {
-            boss.patrol();
+            boss.patrol(*this);
             if (boss.distance(player) <= boss.data()->distance_chase)
             {
                 boss.setState(CBoss::BossState::Chase);
@@ -394,6 +390,9 @@ void CGame::manageMonsters(const int ticks)
         }
     }
 
+    // explosions are resolved once all the actors had their turn
+    resolveBlasts(deletedMonsters);
+
     // moved here to avoid reallocation while using a reference
     for (auto &monster : newMonsters)
     {
@@ -416,7 +415,7 @@ void CGame::manageMonsters(const int ticks)
 void CGame::handleMonster(CActor &actor, const TileDef &def)
 {
     static constexpr JoyAim g_dirs[] = {AIM_UP, AIM_DOWN, AIM_LEFT, AIM_RIGHT};
-    if (actor.isPlayerThere(actor.getAim()))
+    if (actor.isPlayerThere(*this, actor.getAim()))
     {
         // apply health damages
         addHealth(def.health);
@@ -426,7 +425,7 @@ void CGame::handleMonster(CActor &actor, const TileDef &def)
         }
     }
     bool reverse = def.ai & AI_REVERSE;
-    JoyAim aim = actor.findNextDir(reverse);
+    JoyAim aim = actor.findNextDir(*this, reverse);
     if (aim != AIM_NONE)
     {
         shadowActorMove(actor, aim);
@@ -438,7 +437,7 @@ void CGame::handleMonster(CActor &actor, const TileDef &def)
     for (uint8_t i = 0; i < sizeof(g_dirs); ++i)
     {
         if (actor.getAim() != g_dirs[i] &&
-            actor.isPlayerThere(g_dirs[i]))
+            actor.isPlayerThere(*this, g_dirs[i]))
         {
             // apply health damages
             addHealth(def.health);
@@ -458,7 +457,7 @@ void CGame::handleDrone(CActor &actor, const TileDef &def)
     {
         aim = AIM_LEFT;
     }
-    if (actor.isPlayerThere(actor.getAim()))
+    if (actor.isPlayerThere(*this, actor.getAim()))
     {
         // apply health damages
         addHealth(def.health);
@@ -467,7 +466,7 @@ void CGame::handleDrone(CActor &actor, const TileDef &def)
             return;
         }
     }
-    if (actor.canMove(aim))
+    if (actor.canMove(*this, aim))
     {
         shadowActorMove(actor, aim);
     }
@@ -484,7 +483,7 @@ void CGame::handleVamPlant(CActor &actor, const TileDef &def, std::vector<CActor
 
     for (uint8_t i = 0; i < sizeof(g_dirs); ++i)
     {
-        const Pos p = CGame::translate(Pos{actor.x(), actor.y()}, g_dirs[i]);
+        const Pos p = translate(Pos{actor.x(), actor.y()}, g_dirs[i]);
         const uint8_t ct = m_map.at(p.x, p.y);
         const TileDef &defT = getTileDef(ct);
         if (defT.type == TYPE_PLAYER)
@@ -519,13 +518,13 @@ void CGame::handleCrusher(CActor &actor, const bool speeds[])
         return;
     }
     JoyAim aim = actor.getAim();
-    const bool isPlayerThere = actor.isPlayerThere(aim);
+    const bool isPlayerThere = actor.isPlayerThere(*this, aim);
     if (isPlayerThere && !isGodMode())
     {
         // apply health damages
         addHealth(AUTOKILL);
     }
-    if (actor.canMove(aim) && !(isPlayerThere && isGodMode()))
+    if (actor.canMove(*this, aim) && !(isPlayerThere && isGodMode()))
         shadowActorMove(actor, aim);
     else if (aim == AIM_LEFT)
         aim = AIM_RIGHT;
@@ -552,7 +551,7 @@ void CGame::handleIceCube(CActor &actor)
     }
 
     // Check player
-    if (actor.isPlayerThere(aim) && !isGodMode())
+    if (actor.isPlayerThere(*this, aim) && !isGodMode())
     {
         addHealth(AUTOKILL);
         actor.setAim(AIM_NONE);
@@ -568,7 +567,7 @@ void CGame::handleIceCube(CActor &actor)
             return;
         }
     }
-    else if (!actor.canMove(aim))
+    else if (!actor.canMove(*this, aim))
     {
         actor.setAim(AIM_NONE);
         return;
@@ -578,96 +577,125 @@ void CGame::handleIceCube(CActor &actor)
     shadowActorMove(actor, aim);
 }
 
-void CGame::blastRadius(const Pos &pos, const size_t radius, const int damage, std::set<int, std::greater<int>> &deletedMonsters)
+/**
+ * @brief Queue an explosion. Blasts are resolved in a single pass at the end of the tick
+ *
+ * @param pos center of the blast
+ * @param radius blast radius in tiles
+ * @param damage damage at the center (scaled down with distance)
+ */
+void CGame::blastRadius(const Pos &pos, const int radius, const int damage)
 {
-    // compute blast radius
-    std::vector<int> index;
-    index.reserve(radius * 2 + 1);
-    for (size_t i = 0; i < radius; ++i)
-        index.emplace_back(-radius + i);
-    index.emplace_back(0);
-    for (size_t i = 0; i < radius; ++i)
-        index.emplace_back(i + 1);
-
-    struct blastPos_t
-    {
-        Pos pos;
-        int damage;
-        const Pos &toPos() const { return pos; }
-    };
-    std::vector<blastPos_t> blastPositions;
+    m_blasts.emplace_back(blast_t{pos, radius, damage});
+}
+
+/**
+ * @brief Resolve all the blasts queued during this tick.
+ *        Damage is accumulated into a per-cell grid so that each cell
+ *        is resolved only once, no matter how many blasts overlap it.
+ *
+ * @param deletedMonsters
+ */
+void CGame::resolveBlasts(std::set<int, std::greater<int>> &deletedMonsters)
+{
+    if (m_blasts.empty())
+        return;
 
-    // apply blast radius
-    for (size_t i = 0; i < index.size(); ++i)
+    const int len = m_map.len();
+    const size_t cellCount = static_cast<size_t>(len) * m_map.hei();
+    if (m_blastVisited.size() != cellCount)
     {
-        const auto &ty = index[i];
-        for (size_t j = 0; j < index.size(); ++j)
+        m_blastVisited.assign(cellCount, 0);
+        m_blastDamage.assign(cellCount, 0);
+    }
+    m_blastCells.clear();
+
+    // accumulate the damage for each cell covered by a blast
+    for (const auto &blast : m_blasts)
+    {
+        for (int ty = -blast.radius; ty <= blast.radius; ++ty)
         {
-            const auto &tx = index[j];
-            const int16_t x = pos.x + tx;
-            const int16_t y = pos.y + ty;
-            if (m_map.isValid(x, y))
+            for (int tx = -blast.radius; tx <= blast.radius; ++tx)
             {
-                int distance = (std::abs(tx) + std::abs(ty)) / 2;
-                int radiusDamage = distance ? damage / std::abs(distance) : damage;
-                blastPositions.emplace_back(blastPos_t{Pos{x, y}, std::abs(radiusDamage)});
-
-                // check player for splash danage
-                if (m_player.pos() == Pos{x, y})
-                {
-                    addHealth(radiusDamage);
-                    continue;
-                }
-
-                if (tx == 0 && ty == 0)
+                const int x = blast.pos.x + tx;
+                const int y = blast.pos.y + ty;
+                if (!m_map.isValid(x, y))
                     continue;
-
-                // check for intersection with mob monster and other actors
-                const int id = findMonsterAt(x, y);
-                if (id != INVALID && !deletedMonsters.count(id))
+                const int distance = (std::abs(tx) + std::abs(ty)) / 2;
+                const int radiusDamage = std::abs(distance ? blast.damage / distance : blast.damage);
+                const uint32_t cell = x + y * len;
+                if (!m_blastVisited[cell])
                 {
-                    CActor &actor = m_monsters[id];
-                    if (actor.type() == TYPE_BARREL)
-                    {
-                        // light other barrels
-                        fuseBarrel({x, y});
-                    }
-                    else if (actor.type() == TYPE_MONSTER || actor.type() == TYPE_DRONE || actor.type() == TYPE_VAMPLANT)
-                    {
-                        // kill mob monsters
-                        deletedMonsters.emplace(id);
-                        m_sfx.emplace_back(sfx_t{pos.x, pos.y, SFX_EXPLOSION0, SFX_EXPLOSION0_TIMEOUT});
-                    }
-                    else if (actor.type() == TYPE_ICECUBE)
-                    {
-                        // melt icecubes
-                        deletedMonsters.emplace(id);
-                        m_sfx.emplace_back(sfx_t{pos.x, pos.y, SFX_EXPLOSION6, SFX_EXPLOSION6_TIMEOUT});
-                    }
+                    m_blastVisited[cell] = 1;
+                    m_blastCells.emplace_back(cell);
                 }
+                m_blastDamage[cell] = std::max(m_blastDamage[cell], radiusDamage);
             }
         }
     }
+    m_blasts.clear();
+
+    // resolve the player and the actors caught in the blast
+    for (const auto &cell : m_blastCells)
+    {
+        const Pos pos{static_cast<int16_t>(cell % len), static_cast<int16_t>(cell / len)};
+
+        // check player for splash danage
+        if (m_player.pos() == pos)
+        {
+            addHealth(-m_blastDamage[cell]);
+            continue;
+        }
+
+        // check for intersection with mob monster and other actors
+        const int id = findMonsterAt(pos.x, pos.y);
+        if (id == INVALID || deletedMonsters.count(id))
+            continue;
+
+        const CActor &actor = m_monsters[id];
+        if (actor.type() == TYPE_BARREL)
+        {
+            // light other barrels
+            fuseBarrel(pos);
+        }
+        else if (actor.type() == TYPE_MONSTER || actor.type() == TYPE_DRONE || actor.type() == TYPE_VAMPLANT)
+        {
+            // kill mob monsters
+            deletedMonsters.emplace(id);
+            m_sfx.emplace_back(sfx_t{pos.x, pos.y, SFX_EXPLOSION0, SFX_EXPLOSION0_TIMEOUT});
+        }
+        else if (actor.type() == TYPE_ICECUBE)
+        {
+            // melt icecubes
+            deletedMonsters.emplace(id);
+            m_sfx.emplace_back(sfx_t{pos.x, pos.y, SFX_EXPLOSION6, SFX_EXPLOSION6_TIMEOUT});
+        }
+    }
 
     // test boss hitbox
     for (auto &boss : m_bosses)
     {
         int bossDamage = 0;
-        for (const auto &bp : blastPositions)
-        {
-            boss.testHitbox1(m_map, [&bp](const Pos &p, const auto type) { //
-                // check if damage can occur
-                return type != BossData::HitBoxType::SPECIAL1 && p == bp.toPos();
-            },
-                             [boss, &bp, &bossDamage](const HitResult &)
-                             {
-                                 // compute maximum damage
-                                 bossDamage = std::max(bp.damage, bossDamage); //
-                             });
-        }
+        boss.testHitbox1(m_map, [this, len](const Pos &p, const auto type) { //
+            // check if damage can occur
+            return type != BossData::HitBoxType::SPECIAL1 && m_blastVisited[p.x + p.y * len];
+        },
+                         [this, len, &bossDamage](const HitResult &r)
+                         {
+                             // compute maximum damage
+                             bossDamage = std::max(m_blastDamage[r.pos.x + r.pos.y * len], bossDamage); //
+                         });
         if (bossDamage)
             boss.subtainDamage(bossDamage);
     }
+
+    // clear the cells touched during this tick
+    for (const auto &cell : m_blastCells)
+    {
+        m_blastVisited[cell] = 0;
+        m_blastDamage[cell] = 0;
+    }
+    m_blastCells.clear();
 }
 
 void CGame::handleBarrel(CActor &actor, const TileDef &def, const int i, std::set<int, std::greater<int>> &deletedMonsters)
@@ -686,7 +714,7 @@ void CGame::handleBarrel(CActor &actor, const TileDef &def, const int i, std::se
         m_map.set(pos.x, pos.y, TILES_BARREL2EX);
         playSound(SOUND_EXPLOSION1);
         m_gameStats->set(S_FLASH, 1);
-        blastRadius(pos, 2, def.health, deletedMonsters);
+        blastRadius(pos, 2, def.health);
     }
 }
 
@@ -696,18 +724,18 @@ void CGame::handleBullet(CActor &actor, const TileDef &def, const int i, const b
     JoyAim aim = actor.getAim();
     if (actor.isFollowingPath())
     {
-        auto result = actor.followPath(m_player.pos());
+        auto result = actor.followPath(*this, m_player.pos());
         if (result == CPath::Result::MoveSuccesful)
             return;
         isMoving = result != CPath::Result::Blocked && actor.getTTL() != 0;
         aim = actor.getAim();
-        // if (actor.canMove(aim) && actor.getTTL() != 0)
+        // if (actor.canMove(*this, aim) && actor.getTTL() != 0)
         //     return;
-        // LOGI("sprite: %p not moving result:[%d]; aim=[%d] isPlayerThere=[%d] [%p]", &actor, result, actor.getAim(), actor.isPlayerThere(aim), actor.path());
+        // LOGI("sprite: %p not moving result:[%d]; aim=[%d] isPlayerThere=[%d] [%p]", &actor, result, actor.getAim(), actor.isPlayerThere(*this, aim), actor.path());
     }
     else
     {
-        isMoving = actor.canMove(aim);
+        isMoving = actor.canMove(*this, aim);
         if (isMoving)
             shadowActorMove(actor, aim);
     }
@@ -724,10 +752,10 @@ void CGame::handleBullet(CActor &actor, const TileDef &def, const int i, const b
             .sfxID = bullet.sfxID,
             .timeout = bullet.sfxTimeOut,
         });
-        if (CGame::translate(Pos{actor.x(), actor.y()}, aim) == actor.pos())
+        if (translate(Pos{actor.x(), actor.y()}, aim) == actor.pos())
             // coordonate outside map bounds
             return;
-        const uint8_t tileID = actor.tileAt(aim);
+        const uint8_t tileID = actor.tileAt(*this, aim);
         const TileDef &defX = getTileDef(tileID);
         if (defX.type == TYPE_ICECUBE)
         {
@@ -741,7 +769,7 @@ void CGame::handleBullet(CActor &actor, const TileDef &def, const int i, const b
                 m_map.set(pos.x, pos.y, TILES_BLANK);
             }
         }
-        else if (actor.isPlayerThere(aim) && !isGodMode())
+        else if (actor.isPlayerThere(*this, aim) && !isGodMode())
         {
             addHealth(def.health);
         }
@@ -770,7 +798,7 @@ bool CGame::pushChain(const int x, const int y, const JoyAim aim)
         return false;
 
     // CRITICAL: Check canMove() BEFORE pushing
-    if (!m_monsters[i].canMove(aim))
+    if (!m_monsters[i].canMove(*this, aim))
         return false;
 
     Pos next = translate({(int16_t)x, (int16_t)y}, aim);
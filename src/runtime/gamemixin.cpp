@@ -28,6 +28,7 @@
 #include "animator.h"
 #include "chars.h"
 #include "recorder.h"
+#include "rewind.h"
 #include "events.h"
 #include "states.h"
 #include "statedata.h"
@@ -42,24 +43,9 @@
 #include "boss.h"
 #include "gamesfx.h"
 #include "tilesdefs.h"
-
-// Check windows
-#ifdef _WIN64
-#define ENVIRONMENT64
-#else
-#ifdef _WIN32
-#define ENVIRONMENT32
-#endif
-#endif
-
-// Check GCC
-#if __GNUC__
-#if __x86_64__ || __ppc64__
-#define ENVIRONMENT64
-#else
-#define ENVIRONMENT32
-#endif
-#endif
+#include "tintcache.h"
+#include "background.h"
+#include "bandrenderer.h"
 
 CGameMixin::CGameMixin()
 {
@@ -71,6 +57,11 @@ CGameMixin::CGameMixin()
     clearKeyStates();
     clearButtonStates();
     m_recorder = std::make_unique<CRecorder>();
+    m_rewind = std::make_unique<CRewind>();
+    m_tintCache = std::make_unique<CTintCache>();
+    m_background = std::make_unique<CBackground>();
+    m_background->init(*m_animator);
+    m_bands = std::make_unique<CBandRenderer>();
     m_eventCountdown = 0;
     m_currentEvent = EVENT_NONE;
     initUI();
@@ -239,61 +230,15 @@ void CGameMixin::drawRect(CFrame &frame, const rect_t &rect, const Color color,
  * @param colorMap
  */
 
-void CGameMixin::drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile, const rect_t &rect, const ColorMask colorMask, std::unordered_map<uint32_t, uint32_t> *colorMap)
+void CGameMixin::drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile, const rect_t &rect, const ColorMask colorMask, const colorMap_t *colorMap)
 {
-    const int width = bitmap.width();
-    uint32_t *dest = bitmap.getRGB().data() + x + y * width;
-    if (!colorMask && !colorMap)
-    {
-        for (int row = 0; row < rect.height; ++row)
-        {
-            for (int col = 0; col < rect.width; ++col)
-            {
-                auto color = tile.at(col + rect.x, row + rect.y);
-                if (!(color & ALPHA))
-                    continue;
-                dest[col] = color;
-            }
-            dest += width;
-        }
-    }
-    else
-    {
-        const uint32_t colorFilter = fazFilter(FAZ_INV_BITSHIFT);
-        for (int row = 0; row < rect.height; ++row)
-        {
-            for (int col = 0; col < rect.width; ++col)
-            {
-                uint32_t color = tile.at(col + rect.x, row + rect.y);
-                if (!(color & ALPHA))
-                    continue;
-                if (colorMap && colorMap->count(color))
-                {
-                    color = (*colorMap)[color];
-                }
-                if (colorMask == COLOR_FADE)
-                {
-                    color = ((color >> FAZ_INV_BITSHIFT) & colorFilter) | ALPHA;
-                }
-                else if (colorMask == COLOR_INVERTED)
-                {
-                    color ^= 0x00ffffff;
-                }
-                else if (colorMask == COLOR_GRAYSCALE)
-                {
-                    uint8_t *c = reinterpret_cast<uint8_t *>(&color);
-                    const uint16_t avg = (c[0] + c[1] + c[2]) / 3;
-                    c[0] = c[1] = c[2] = avg;
-                }
-                else if (colorMask == COLOR_ALL_WHITE)
-                {
-                    color = WHITE;
-                }
-                dest[col] = color;
-            }
-            dest += width;
-        }
-    }
+    blitOp_t op;
+    op.transparency = BLIT_SKIP_ALPHA;
+    op.effect = blitEffect(colorMask);
+    op.shift = colorMask == COLOR_FADE ? static_cast<uint8_t>(FAZ_INV_BITSHIFT) : 0;
+    op.colorMap = colorMap;
+    const uint32_t *tileData = tile.getRGB().data() + rect.x + rect.y * tile.width();
+    blit(bitmap.getRGB().data() + x + y * bitmap.width(), bitmap.width(), tileData, tile.width(), rect.width, rect.height, op);
 }
 
 /**
@@ -308,132 +253,43 @@ void CGameMixin::drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile
  * @param colorMap
  */
 
-void CGameMixin::drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile, const bool alpha, const ColorMask colorMask, std::unordered_map<uint32_t, uint32_t> *colorMap)
+void CGameMixin::drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile, const bool alpha, const ColorMask colorMask, const colorMap_t *colorMap)
 {
-    const int width = bitmap.width();
-    const uint32_t *tileData = tile.getRGB().data();
-    uint32_t *dest = bitmap.getRGB().data() + x + y * width;
-    if (alpha || colorMask || colorMap)
-    {
-        const uint32_t colorFilter = fazFilter(FAZ_INV_BITSHIFT);
-        for (uint32_t row = 0; row < TILE_SIZE; ++row)
-        {
-            for (uint32_t col = 0; col < TILE_SIZE; ++col)
-            {
-                uint32_t color = tileData[col];
-                if (!color)
-                    continue;
-                if (colorMap && colorMap->count(color))
-                {
-                    color = (*colorMap)[color];
-                }
-                if (colorMask == COLOR_FADE)
-                {
-                    color = ((color >> FAZ_INV_BITSHIFT) & colorFilter) | ALPHA;
-                }
-                else if (colorMask == COLOR_INVERTED)
-                {
-                    color ^= 0x00ffffff;
-                }
-                else if (colorMask == COLOR_GRAYSCALE)
-                {
-                    uint8_t *c = reinterpret_cast<uint8_t *>(&color);
-                    const uint16_t avg = (c[0] + c[1] + c[2]) / 3;
-                    c[0] = c[1] = c[2] = avg;
-                }
-                else if (colorMask == COLOR_ALL_WHITE)
-                {
-                    color = WHITE;
-                }
-                dest[col] = color;
-            }
-            dest += width;
-            tileData += TILE_SIZE;
-        }
-    }
-    else
-    {
-
-#ifdef ENVIRONMENT64
-        uint64_t *d64 = reinterpret_cast<uint64_t *>(dest);
-        const uint64_t *s64 = reinterpret_cast<const uint64_t *>(tileData);
-        for (uint32_t row = 0; row < TILE_SIZE; ++row)
-        {
-            int i = 0;
-            d64[i++] = *(s64++);
-            d64[i++] = *(s64++);
-            d64[i++] = *(s64++);
-            d64[i++] = *(s64++);
-
-            d64[i++] = *(s64++);
-            d64[i++] = *(s64++);
-            d64[i++] = *(s64++);
-            d64[i++] = *(s64++);
-            d64 += width / 2;
-        }
-#else
-        for (uint32_t row = 0; row < TILE_SIZE; ++row)
-        {
-            int i = 0;
-
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest[i++] = *(tileData++);
-            dest += width;
-        }
-#endif
-    }
+    blitOp_t op;
+    op.transparency = alpha || colorMask || colorMap ? BLIT_SKIP_CLEAR : BLIT_OPAQUE;
+    op.effect = blitEffect(colorMask);
+    op.shift = colorMask == COLOR_FADE ? static_cast<uint8_t>(FAZ_INV_BITSHIFT) : 0;
+    op.colorMap = colorMap;
+    blit(bitmap.getRGB().data() + x + y * bitmap.width(), bitmap.width(), tile.getRGB().data(), TILE_SIZE, TILE_SIZE, TILE_SIZE, op);
 }
 
 void CGameMixin::drawTileFaz(CFrame &bitmap, const int x, const int y, CFrame &tile, int fazBitShift, const ColorMask colorMask)
 {
-    const int width = bitmap.width();
-    const uint32_t *tileData = tile.getRGB().data();
-    uint32_t *dest = bitmap.getRGB().data() + x + y * width;
-    const uint32_t colorFilter = fazBitShift ? fazFilter(fazBitShift) : 0;
-    for (uint32_t row = 0; row < TILE_SIZE; ++row)
+    blitOp_t op;
+    op.transparency = BLIT_SKIP_CLEAR;
+    op.effect = blitEffect(colorMask);
+    op.shift = fazBitShift;
+    blit(bitmap.getRGB().data() + x + y * bitmap.width(), bitmap.width(), tile.getRGB().data(), TILE_SIZE, TILE_SIZE, TILE_SIZE, op);
+}
+
+/**
+ * @brief Blitter effect of a color mask. COLOR_FADE is a shift, not an effect
+ *
+ * @param colorMask
+ * @return BlitEffect
+ */
+BlitEffect CGameMixin::blitEffect(const ColorMask colorMask)
+{
+    switch (colorMask)
     {
-        for (uint32_t col = 0; col < TILE_SIZE; ++col)
-        {
-            uint32_t color = tileData[col];
-            if (!color)
-                continue;
-            if (fazBitShift)
-                color = ((color >> fazBitShift) & colorFilter) | ALPHA;
-            if (colorMask == COLOR_INVERTED)
-            {
-                color ^= 0x00ffffff;
-            }
-            else if (colorMask == COLOR_GRAYSCALE)
-            {
-                uint8_t *c = reinterpret_cast<uint8_t *>(&color);
-                const uint16_t avg = (c[0] + c[1] + c[2]) / 3;
-                c[0] = c[1] = c[2] = avg;
-            }
-            else if (colorMask == COLOR_ALL_WHITE)
-            {
-                color = WHITE;
-            }
-            dest[col] = color;
-        }
-        dest += width;
-        tileData += TILE_SIZE;
+    case COLOR_INVERTED:
+        return BLIT_INVERTED;
+    case COLOR_GRAYSCALE:
+        return BLIT_GRAYSCALE;
+    case COLOR_ALL_WHITE:
+        return BLIT_ALL_WHITE;
+    default:
+        return BLIT_NOCHANGE;
     }
 }
 
@@ -528,6 +384,9 @@ void CGameMixin::drawScreen(CFrame &bitmap)
 
     // draw timeout
     drawTimeout(bitmap);
+
+    // stats drawn on this frame are now up to date
+    m_game->stats().clearChanged();
 }
 
 void CGameMixin::drawScroll(CFrame &bitmap)
@@ -548,7 +407,7 @@ void CGameMixin::drawScroll(CFrame &bitmap)
 
 void CGameMixin::drawTimeout(CFrame &bitmap)
 {
-    const CMap *map = &m_game->getMap();
+    const CMap *map = &m_game->map();
     const CStates &states = map->statesConst();
     const uint16_t timeout = states.getU(TIMEOUT);
     if (timeout)
@@ -565,16 +424,12 @@ void CGameMixin::drawTimeout(CFrame &bitmap)
     }
 }
 
-CFrame *CGameMixin::tile2Frame(const uint8_t tileID, ColorMask &colorMask, std::unordered_map<uint32_t, uint32_t> *&colorMap)
+CFrame *CGameMixin::tile2Frame(const uint8_t tileID, bool &alpha)
 {
     const CGame &game = *m_game;
     CFrame *tile;
-    if (tileID == TILES_STOP || tileID == TILES_BLANK || m_animator->isSpecialCase(tileID))
-    {
-        // skip blank tiles and special cases
-        tile = nullptr;
-    }
-    else if (tileID == TILES_ANNIE2)
+    alpha = false;
+    if (tileID == TILES_ANNIE2)
     {
         const uint8_t userID = game.getUserID();
         const uint32_t userBaseFrame = PLAYER_TOTAL_FRAMES * userID;
@@ -604,6 +459,8 @@ CFrame *CGameMixin::tile2Frame(const uint8_t tileID, ColorMask &colorMask, std::
             tile = annie[aim * PLAYER_FRAMES + m_playerFrameOffset + userBaseFrame];
         }
 
+        ColorMask colorMask = COLOR_NOCHANGE;
+        const colorMap_t *colorMap = nullptr;
         const int hurtStage = game.statsConst().at(S_PLAYER_HURT);
         if (hurtStage == CGame::HurtFlash)
             colorMask = COLOR_ALL_WHITE;
@@ -611,8 +468,6 @@ CFrame *CGameMixin::tile2Frame(const uint8_t tileID, ColorMask &colorMask, std::
             colorMask = COLOR_INVERTED;
         else if (hurtStage == CGame::HurtFaz)
             colorMask = COLOR_FADE;
-        else
-            colorMask = COLOR_NOCHANGE;
 
         if (m_game->isFrozen())
         {
@@ -630,28 +485,57 @@ CFrame *CGameMixin::tile2Frame(const uint8_t tileID, ColorMask &colorMask, std::
         {
             colorMap = &m_colormaps.rage;
         }
+
+        // recoloured frames are made once and drawn with transparency
+        if (colorMask != COLOR_NOCHANGE || colorMap)
+        {
+            if (m_tintVersion != m_colormaps.version)
+            {
+                m_tintCache->clear();
+                m_tintVersion = m_colormaps.version;
+            }
+            blitOp_t op;
+            op.effect = blitEffect(colorMask);
+            op.shift = colorMask == COLOR_FADE ? static_cast<uint8_t>(FAZ_INV_BITSHIFT) : 0;
+            op.colorMap = colorMap;
+            tile = m_tintCache->get(tile, op);
+            alpha = true;
+        }
     }
     else
     {
-        const uint16_t j = m_animator->at(tileID);
-        if (j == NO_ANIMZ)
-        {
-            const CFrameSet &tiles = *m_tiles;
-            tile = tiles[tileID];
-        }
-        else
-        {
-            const CFrameSet &animz = *m_animz;
-            tile = animz[j];
-        }
+        // resolved once per animation step; blank tiles and special cases are nullptr
+        tile = m_animator->frame(tileID);
     }
     return tile;
 }
 
+/**
+ * @brief tile2Frame() for the row bands, which run on several threads:
+ *        the player's frame, whose tinted variants are made on demand,
+ *        is resolved by the caller beforehand
+ *
+ * @param tileID
+ * @param alpha
+ * @param player frame of TILES_ANNIE2
+ * @param playerAlpha
+ * @return CFrame*
+ */
+CFrame *CGameMixin::bandFrame(const uint8_t tileID, bool &alpha, CFrame *player, const bool playerAlpha) const
+{
+    if (tileID == TILES_ANNIE2)
+    {
+        alpha = playerAlpha;
+        return player;
+    }
+    alpha = false;
+    return m_animator->frame(tileID);
+}
+
 void CGameMixin::gatherSprites(std::vector<sprite_t> &sprites, const cameraContext_t &context)
 {
     CGame &game = *m_game;
-    CMap *map = &m_game->getMap();
+    CMap *map = &m_game->map();
     const int maxRows = getHeight() / TILE_SIZE;
     const int maxCols = getWidth() / TILE_SIZE;
     const int rows = std::min(maxRows, map->hei());
@@ -696,7 +580,7 @@ void CGameMixin::gatherSprites(std::vector<sprite_t> &sprites, const cameraConte
 
 void CGameMixin::drawViewPortDynamic(CFrame &bitmap)
 {
-    const CMap *map = &m_game->getMap();
+    const CMap *map = &m_game->map();
     const int maxRows = getHeight() / TILE_SIZE;
     const int maxCols = getWidth() / TILE_SIZE;
     const int rows = std::min(maxRows, map->hei());
@@ -708,45 +592,56 @@ void CGameMixin::drawViewPortDynamic(CFrame &bitmap)
     const int halfOffset = TILE_SIZE / 2;
     const int tileSize = TILE_SIZE;
 
-    bitmap.fill(BLACK);
-    int py = oy ? -halfOffset : 0;
-    for (int y = 0; y < rows + oy; ++y)
-    {
-        bool firstY = oy && y == 0;
-        bool lastY = oy && y == rows;
-        int px = ox ? -halfOffset : 0;
-        for (int x = 0; x < cols + ox; ++x)
-        {
-            bool firstX = ox && x == 0;
-            bool lastX = ox && x == cols;
-            uint8_t tileID = map->at(x + mx, y + my);
-            ColorMask colorMask = COLOR_NOCHANGE;
-            std::unordered_map<uint32_t, uint32_t> *colorMap = nullptr;
-            CFrame *tile = tile2Frame(tileID, colorMask, colorMap);
-            if (tile)
+    // static tiles come from the level background, the rest is drawn over
+    if (cols * tileSize < bitmap.width() || rows * tileSize < bitmap.height())
+        bitmap.fill(BLACK);
+    m_background->sync(*map, *m_tiles, mx, my, cols + ox, rows + oy);
+    m_background->draw(bitmap, mx * TILE_SIZE + ox * halfOffset, my * TILE_SIZE + oy * halfOffset, cols * TILE_SIZE, rows * TILE_SIZE);
+    bool playerAlpha;
+    CFrame *player = tile2Frame(TILES_ANNIE2, playerAlpha);
+    // tiles by bands of rows, on several threads; sprites and bosses
+    // cross the bands and are drawn afterwards
+    auto drawRows = [&](const int, const int first, const int last)
+    {
+        for (int y = first; y < last; ++y)
+        {
+            bool firstY = oy && y == 0;
+            bool lastY = oy && y == rows;
+            int py = y * TILE_SIZE - (oy ? halfOffset : 0);
+            int px = ox ? -halfOffset : 0;
+            for (int x = 0; x < cols + ox; ++x, px += TILE_SIZE)
             {
-                if (firstX || firstY || lastX || lastY)
-                {
-                    rect_t rect{
-                        .x = !firstX ? 0 : halfOffset,
-                        .y = !firstY ? 0 : halfOffset,
-                        .width = !(firstX || lastX) ? tileSize : halfOffset,
-                        .height = !(firstY || lastY) ? tileSize : halfOffset,
-                    };
-                    drawTile(bitmap,
-                             !firstX ? px : 0,
-                             !firstY ? py : 0,
-                             *tile, rect, colorMask, colorMap);
-                }
-                else
+                bool firstX = ox && x == 0;
+                bool lastX = ox && x == cols;
+                uint8_t tileID = map->at(x + mx, y + my);
+                if (m_background->isStatic(tileID))
+                    continue;
+                bool alpha;
+                CFrame *tile = bandFrame(tileID, alpha, player, playerAlpha);
+                if (tile)
                 {
-                    drawTile(bitmap, px, py, *tile, false, colorMask, colorMap);
+                    if (firstX || firstY || lastX || lastY)
+                    {
+                        rect_t rect{
+                            .x = !firstX ? 0 : halfOffset,
+                            .y = !firstY ? 0 : halfOffset,
+                            .width = !(firstX || lastX) ? tileSize : halfOffset,
+                            .height = !(firstY || lastY) ? tileSize : halfOffset,
+                        };
+                        drawTile(bitmap,
+                                 !firstX ? px : 0,
+                                 !firstY ? py : 0,
+                                 *tile, rect);
+                    }
+                    else
+                    {
+                        drawTile(bitmap, px, py, *tile, alpha);
+                    }
                 }
             }
-            px += TILE_SIZE;
         }
-        py += TILE_SIZE;
-    }
+    };
+    m_bands->run(rows + oy, drawRows);
 
     /////////////////////////////////////////////////////////////////////////////
     // overlay special case monsters and sfx
@@ -792,7 +687,7 @@ void CGameMixin::drawViewPortDynamic(CFrame &bitmap)
 
 void CGameMixin::drawViewPortStatic(CFrame &bitmap)
 {
-    const CMap *map = &m_game->getMap();
+    const CMap *map = &m_game->map();
     const CGame &game = *m_game;
 
     const int maxRows = getHeight() / TILE_SIZE;
@@ -804,28 +699,33 @@ void CGameMixin::drawViewPortStatic(CFrame &bitmap)
     const int lmy = std::max(0, game.playerConst().y() - rows / 2);
     const int mx = std::min(lmx, map->len() > cols ? map->len() - cols : 0);
     const int my = std::min(lmy, map->hei() > rows ? map->hei() - rows : 0);
-    bitmap.fill(BLACK);
-    for (int y = 0; y < rows; ++y)
-    {
-        for (int x = 0; x < cols; ++x)
-        {
-            uint8_t tileID = map->at(x + mx, y + my);
-            ColorMask inverted = COLOR_NOCHANGE;
-            std::unordered_map<uint32_t, uint32_t> *colorMap = nullptr;
-            CFrame *tile = tile2Frame(tileID, inverted, colorMap);
-            if (tile)
+    if (cols * static_cast<int>(TILE_SIZE) < bitmap.width() || rows * static_cast<int>(TILE_SIZE) < bitmap.height())
+        bitmap.fill(BLACK);
+    m_background->sync(*map, *m_tiles, mx, my, cols, rows);
+    m_background->draw(bitmap, mx * TILE_SIZE, my * TILE_SIZE, cols * TILE_SIZE, rows * TILE_SIZE);
+    bool playerAlpha;
+    CFrame *player = tile2Frame(TILES_ANNIE2, playerAlpha);
+    // tiles by bands of rows, on several threads; sprites and bosses
+    // cross the bands and are drawn afterwards
+    auto drawRows = [&](const int, const int first, const int last)
+    {
+        for (int y = first; y < last; ++y)
+        {
+            for (int x = 0; x < cols; ++x)
             {
-                if (colorMap != nullptr || inverted)
-                {
-                    drawTile(bitmap, x * TILE_SIZE, y * TILE_SIZE, *tile, false, inverted, colorMap);
-                }
-                else
+                uint8_t tileID = map->at(x + mx, y + my);
+                if (m_background->isStatic(tileID))
+                    continue;
+                bool alpha;
+                CFrame *tile = bandFrame(tileID, alpha, player, playerAlpha);
+                if (tile)
                 {
-                    drawTile(bitmap, x * TILE_SIZE, y * TILE_SIZE, *tile, false);
+                    drawTile(bitmap, x * TILE_SIZE, y * TILE_SIZE, *tile, alpha);
                 }
             }
         }
-    }
+    };
+    m_bands->run(rows, drawRows);
 
     std::vector<sprite_t> sprites;
     gatherSprites(sprites, {.mx = mx, .ox = 0, .my = my, .oy = 0});
@@ -948,7 +848,7 @@ void CGameMixin::drawBossses(CFrame &bitmap, const int mx, const int my, const i
             continue;
 
         // Hp Rect
-        const float hpRatio = (float)boss.maxHp() / MAX_HP_GAUGE;
+        const float hpRatio = (float)boss.maxHp(m_game->skill()) / MAX_HP_GAUGE;
         const rect_t hRect{
             .x = bRect.x,
             .y = bRect.y - HP_BAR_HEIGHT - HP_BAR_SPACING,
@@ -986,7 +886,7 @@ void CGameMixin::drawBossses(CFrame &bitmap, const int mx, const int my, const i
 
 void CGameMixin::centerCamera()
 {
-    const CMap *map = &m_game->getMap();
+    const CMap *map = &m_game->map();
     const CGame &game = *m_game;
     const int maxRows = getHeight() / TILE_SIZE;
     const int maxCols = getWidth() / TILE_SIZE;
@@ -1036,7 +936,7 @@ void CGameMixin::drawLevelIntro(CFrame &bitmap)
 
     if (mode == CGame::MODE_LEVEL_INTRO || mode == CGame::MODE_CHUTE)
     {
-        const char *t = m_game->getMap().title();
+        const char *t = m_game->map().title();
         const int x = (getWidth() - strlen(t) * FONT_SIZE) / 2;
         drawFont(bitmap, x, y + 3 * FONT_SIZE, t, WHITE);
     }
@@ -1153,6 +1053,7 @@ void CGameMixin::mainLoop()
         return;
     case CGame::MODE_PLAY:
         manageGamePlay();
+        captureRewind();
         return;
     case CGame::MODE_LEVEL_SUMMARY:
         manageLevelSummary();
@@ -1169,7 +1070,7 @@ void CGameMixin::mainLoop()
 
 void CGameMixin::moveCamera()
 {
-    const CMap &map = CGame::getMap();
+    const CMap &map = m_game->map();
     const int maxRows = getHeight() / TILE_SIZE;
     const int maxCols = getWidth() / TILE_SIZE;
     const int rows = std::min(maxRows, map.hei());
@@ -1207,11 +1108,16 @@ void CGameMixin::manageGamePlay()
 
     if (m_recorder->isRecording())
     {
+        if (m_recorder->wantsCheckpoint())
+            m_recorder->appendCheckpoint(game.stateHash());
         m_recorder->append(joyState);
     }
     else if (m_recorder->isReading())
     {
-        if (!m_recorder->get(joyState))
+        const bool hasInput = m_recorder->get(joyState);
+        if (m_recorder->hasCheckpoint())
+            m_recorder->verify(game.stateHash());
+        if (!hasInput)
         {
             stopRecorder();
         }
@@ -1253,69 +1159,31 @@ void CGameMixin::manageGamePlay()
 
     manageCurrentEvent();
     manageTimer();
-    game.purgeSfx();
-    game.decTimers();
-    if (m_ticks % game.playerSpeed() == 0 && game.closusureTimer())
-    {
-        // decrease closure timer
-        game.decClosure();
-    }
-    else if (m_ticks % game.playerSpeed() == 0 &&
-             !game.isPlayerDead() &&
-             !game.isFrozen())
-    {
-        if (game.managePlayer(joyState) != AIM_NONE)
-        {
-            game.stats().set(S_IDLE_TIME, 0);
-        }
-        else
-        {
-            int &idleTime = game.stats().inc(S_IDLE_TIME);
-            if (idleTime >= MAX_IDLE_CYCLES)
-                idleTime = 0;
-        }
-    }
+    const uint8_t flags = game.tick(m_ticks, joyState, m_healthRef);
 
     if (m_ticks % cameraSpeed() == 0)
     {
         moveCamera();
     }
 
-    if (!game.isFrozen() && m_ticks % 3 == 0)
+    // the walk cycle holds on the tick the player gets hurt
+    if (flags & CGame::TICK_WALK)
     {
-        if (!game.isClosure())
-        {
-            const int hurtStage = game.stats().get(S_PLAYER_HURT);
-            if (game.health() < m_healthRef && hurtStage == CGame::HurtNone)
-            {
-                game.stats().set(S_PLAYER_HURT, CGame::HurtStart);
-            }
-            else if (*(reinterpret_cast<uint32_t *>(joyState)))
-            {
-                m_playerFrameOffset = (m_playerFrameOffset + 1) & PLAYER_STD_FRAMES;
-            }
-            else
-            {
-                m_playerFrameOffset = 0;
-            }
-
-            if (game.health() >= m_healthRef)
-                game.stats().dec(S_PLAYER_HURT);
-            m_healthRef = game.health();
-        }
+        if (*(reinterpret_cast<uint32_t *>(joyState)))
+            m_playerFrameOffset = (m_playerFrameOffset + 1) & PLAYER_STD_FRAMES;
         else
-        {
-            m_playerFrameOffset = (m_playerFrameOffset + 1) % PLAYER_STD_FRAMES;
-        }
+            m_playerFrameOffset = 0;
+    }
+    else if (flags & CGame::TICK_CLOSING)
+    {
+        m_playerFrameOffset = (m_playerFrameOffset + 1) % PLAYER_STD_FRAMES;
     }
 
     if (m_ticks % 3 == 0)
         m_animator->animate();
 
-    game.manageMonsters(m_ticks);
-    game.manageBosses(m_ticks);
-    const uint16_t exitKey = m_game->getMap().states().getU(POS_EXIT);
-    if (game.isClosure())
+    const uint16_t exitKey = m_game->map().states().getU(POS_EXIT);
+    if (flags & CGame::TICK_CLOSURE)
     {
         stopRecorder();
         if (game.closusureTimer() != 0)
@@ -1368,15 +1236,12 @@ void CGameMixin::manageGamePlay()
             }
         }
     }
-    else if (game.goalCount() == 0 && exitKey != 0)
-    {
-        game.checkClosure();
-    }
 }
 
 void CGameMixin::nextLevel()
 {
     stopRecorder();
+    m_rewind->clear();
     m_healthRef = 0;
     m_game->nextLevel();
     sanityTest();
@@ -1386,6 +1251,7 @@ void CGameMixin::nextLevel()
 
 void CGameMixin::restartLevel()
 {
+    m_rewind->clear();
     m_game->restartLevel();
     beginLevelIntro(CGame::MODE_RESTART);
     changeMoodMusic(CGame::MODE_RESTART);
@@ -1394,6 +1260,7 @@ void CGameMixin::restartLevel()
 void CGameMixin::restartGame()
 {
     m_paused = false;
+    m_rewind->clear();
     m_game->restartGame();
     sanityTest();
     beginLevelIntro(CGame::MODE_LEVEL_INTRO);
@@ -1412,9 +1279,12 @@ void CGameMixin::init(CMapArch *maparch, const int index)
         preloadAssets();
         m_assetPreloaded = true;
     }
+    m_animator->setFrameSets(m_tiles.get(), m_animz.get(), true);
     m_maparch = maparch;
     m_game->setMapArch(maparch);
+    m_game->setPrefetch(true);
     m_game->setLevel(index);
+    m_rewind->clear();
     sanityTest();
     beginLevelIntro(CGame::MODE_LEVEL_INTRO);
 }
@@ -1804,20 +1674,12 @@ bool CGameMixin::read(IFile &sfile, std::string &name)
     {
         return sfile.read(ptr, size) == 1;
     };
-    if (!m_game->read(sfile))
+    playState_t state;
+    if (!m_game->read(sfile) || !readPlayState(sfile, state))
     {
         return false;
     }
-    clearButtonStates();
-    clearJoyStates();
-    clearKeyStates();
-    clearVisualStates();
-    m_paused = false;
-    m_prompt = PROMPT_NONE;
-    _R(&m_ticks, sizeof(m_ticks));
-    _R(&m_playerFrameOffset, sizeof(m_playerFrameOffset));
-    _R(&m_healthRef, sizeof(m_healthRef));
-    _R(&m_countdown, sizeof(m_countdown));
+    applyPlayState(state);
 
     size_t ptr = 0;
     sfile.seek(SAVENAME_PTR_OFFSET);
@@ -1833,17 +1695,62 @@ bool CGameMixin::read(IFile &sfile, std::string &name)
     return true;
 }
 
-bool CGameMixin::write(IFile &tfile, const std::string &name)
+/**
+ * @brief Read what the front-end keeps of a session, after the game itself
+ *
+ * @param sfile
+ * @param state receives the values, applied by applyPlayState()
+ * @return true
+ * @return false
+ */
+bool CGameMixin::readPlayState(IFile &sfile, playState_t &state)
+{
+    auto readfile = [&sfile](auto ptr, auto size)
+    {
+        return sfile.read(ptr, size) == 1;
+    };
+    _R(&state.ticks, sizeof(state.ticks));
+    _R(&state.playerFrameOffset, sizeof(state.playerFrameOffset));
+    _R(&state.healthRef, sizeof(state.healthRef));
+    _R(&state.countdown, sizeof(state.countdown));
+    return true;
+}
+
+void CGameMixin::applyPlayState(const playState_t &state)
+{
+    clearButtonStates();
+    clearJoyStates();
+    clearKeyStates();
+    clearVisualStates();
+    m_paused = false;
+    m_prompt = PROMPT_NONE;
+    m_ticks = state.ticks;
+    m_playerFrameOffset = state.playerFrameOffset;
+    m_healthRef = state.healthRef;
+    m_countdown = state.countdown;
+}
+
+bool CGameMixin::writePlayState(IFile &tfile)
 {
     auto writefile = [&tfile](auto ptr, auto size)
     {
         return tfile.write(ptr, size) == 1;
     };
-    m_game->write(tfile);
     _W(&m_ticks, sizeof(m_ticks));
     _W(&m_playerFrameOffset, sizeof(m_playerFrameOffset));
     _W(&m_healthRef, sizeof(m_healthRef));
     _W(&m_countdown, sizeof(m_countdown));
+    return true;
+}
+
+bool CGameMixin::write(IFile &tfile, const std::string &name, const bool pack)
+{
+    auto writefile = [&tfile](auto ptr, auto size)
+    {
+        return tfile.write(ptr, size) == 1;
+    };
+    if (!m_game->write(tfile, pack) || !writePlayState(tfile))
+        return false;
 
     const size_t ptr = tfile.tell();
     const size_t size = name.size();
@@ -1926,6 +1833,7 @@ void CGameMixin::recordGame()
         return;
     }
     write(m_recorderFile, name);
+    m_recorder->setHashInterval(TICK_RATE);
     m_recorder->start(&m_recorderFile, true);
 }
 
@@ -1944,6 +1852,55 @@ void CGameMixin::playbackGame()
     m_recorder->start(&m_recorderFile, false);
 }
 
+/**
+ * @brief Keep a snapshot of the current tick in the rewind buffer: the
+ *        map tiles and the rest of the session as two planes, which the
+ *        buffer stores as deltas against its last keyframe. Only done for
+ *        front-ends that set m_rewindEnabled.
+ *
+ */
+void CGameMixin::captureRewind()
+{
+    if (!m_rewindEnabled || m_paused || m_gameMenuActive || m_game->mode() != CGame::MODE_PLAY)
+        return;
+    m_rewindFile.close();
+    m_rewindFile.open("", "wb");
+    if (writePlayState(m_rewindFile) && m_game->writeSnapshot(m_rewindFile, m_rewindTiles))
+        m_rewind->push(m_ticks, m_rewindTiles, m_rewindFile.buffer());
+}
+
+/**
+ * @brief Go back in time, within the rewind window. Only while playing:
+ *        the intros, summary and game over screens have nothing to go back to.
+ *        The session is left as it was if the snapshot doesn't read back.
+ *
+ * @param ticks how far back
+ * @return true
+ * @return false if there is nothing to rewind to
+ */
+bool CGameMixin::rewind(const uint32_t ticks)
+{
+    if (!m_rewindEnabled || m_game->mode() != CGame::MODE_PLAY || m_rewind->empty())
+        return false;
+    const uint32_t target = m_ticks > ticks ? m_ticks - ticks : 0;
+    if (!m_rewind->restore(std::max(target, m_rewind->oldest()), m_rewindTiles, m_rewindState))
+        return false;
+
+    m_rewindFile.close();
+    m_rewindFile.open("", "rb");
+    m_rewindFile.replace(m_rewindState.data(), m_rewindState.size());
+    playState_t state;
+    if (!readPlayState(m_rewindFile, state) || !m_game->readSnapshot(m_rewindFile, m_rewindTiles))
+    {
+        LOGE("rewind failed");
+        return false;
+    }
+    stopRecorder();
+    applyPlayState(state);
+    m_rewind->discardAfter(m_ticks);
+    return true;
+}
+
 void CGameMixin::plotLine(CFrame &bitmap, int x0, int y0, const int x1, const int y1, const Color color)
 {
     auto dx = abs(x1 - x0);
@@ -2073,7 +2030,7 @@ CGameMixin::message_t CGameMixin::getEventText(const int baseY)
     }
     else if (RANGE(m_currentEvent, MSG0, MSGF))
     {
-        const std::string tmp = m_game->getMap().states().getS(m_currentEvent);
+        const std::string tmp = m_game->map().states().getS(m_currentEvent);
         const auto list = split(tmp, '\n');
         const std::string &line1 = list[0];
         const std::string &line2 = list.size() > 1 ? list[1] : "";
@@ -2201,7 +2158,7 @@ void CGameMixin::manageTimer()
     {
         game.incTimeTaken();
         m_timer = TICK_RATE;
-        CStates &states = game.getMap().states();
+        CStates &states = game.map().states();
         uint16_t timeout = states.getU(TIMEOUT);
         if (timeout == 1)
         {
@@ -2290,9 +2247,11 @@ void CGameMixin::drawSugarMeter(CFrame &bitmap, const int bx)
     // indicate sugar level
     const int x = bx * (int)FONT_SIZE;
     const int y = Y_STATUS + 2 + (int)FONT_SIZE;
-    char tmp[20];
-    snprintf(tmp, sizeof(tmp), "Lvl %d", m_game->stats().get(S_SUGAR_LEVEL) + 1);
-    drawFont6x6(bitmap, x, y, tmp, WHITE, CLEAR);
+    const CGameStats &stats = game.statsConst();
+    char *sugarLevel = m_visualStates.sugarLevel;
+    if (stats.isChanged(S_SUGAR_LEVEL) || !sugarLevel[0])
+        snprintf(sugarLevel, sizeof(m_visualStates.sugarLevel), "Lvl %d", stats.at(S_SUGAR_LEVEL) + 1);
+    drawFont6x6(bitmap, x, y, sugarLevel, WHITE, CLEAR);
 
     if (updateNow)
     {
@@ -2500,6 +2459,7 @@ void CGameMixin::clearVisualStates()
     m_visualStates.rSugar = 0;
     m_visualStates.sugarFx = 0;
     memset(m_visualStates.sugarCubes, '\0', sizeof(m_visualStates.sugarCubes));
+    m_visualStates.sugarLevel[0] = '\0';
 }
 
 void CGameMixin::initUI()
@@ -2550,5 +2510,5 @@ int CGameMixin::whichButton(CGameUI &ui, int x, int y)
 void CGameMixin::setQuiet(bool state)
 {
     m_quiet = state;
-    CGame::getGame()->setQuiet(state);
+    m_game->setQuiet(state);
 }
\ No newline at end of file
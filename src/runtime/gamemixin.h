@@ -31,7 +31,9 @@
 #include "gameui.h"
 #include "rect.h"
 #include "color.h"
+#include "blitter.h"
 #include "shared/FileWrap.h"
+#include "shared/FileMem.h"
 
 class CActor;
 class CFrameSet;
@@ -40,6 +42,10 @@ class CMapArch;
 class CAnimator;
 class IMusic;
 class CRecorder;
+class CRewind;
+class CTintCache;
+class CBackground;
+class CBandRenderer;
 
 class CGameMixin
 {
@@ -81,6 +87,7 @@ protected:
         COUNTDOWN_INTRO = 1,
         COUNTDOWN_RESTART = 2,
         GAME_MENU_COOLDOWN = 10,
+        REWIND_TICKS = 3 * TICK_RATE,
         FONT_SIZE = 8,
         MAX_SCORES = 18,
         KEY_REPETE_DELAY = 5,
@@ -108,7 +115,6 @@ protected:
 
     enum : int32_t
     {
-        MAX_IDLE_CYCLES = 0x100,
         IDLE_ACTIVATION = 0x40,
         MIN_WIDTH_FULL = 320,
         SUGAR_CUBES = 5,
@@ -223,6 +229,7 @@ protected:
         int rSugar = 0;
         int sugarFx = 0;
         uint8_t sugarCubes[SUGAR_CUBES];
+        char sugarLevel[16];
     };
 
     struct hiscore_t
@@ -241,6 +248,14 @@ protected:
         std::string lines[3];
     };
 
+    struct playState_t
+    {
+        uint32_t ticks;
+        int playerFrameOffset;
+        int healthRef;
+        int countdown;
+    };
+
     hiscore_t m_hiscores[MAX_SCORES];
     uint8_t m_joyState[JOY_AIMS];
     uint8_t m_vjoyState[JOY_AIMS];
@@ -258,6 +273,10 @@ protected:
     CGame *m_game = nullptr;
     CMapArch *m_maparch = nullptr;
     std::unique_ptr<CRecorder> m_recorder;
+    std::unique_ptr<CRewind> m_rewind;
+    CFileMem m_rewindFile;
+    std::vector<uint8_t> m_rewindTiles;
+    std::vector<uint8_t> m_rewindState;
     std::vector<std::string> m_helptext;
     int m_playerFrameOffset = 0;
     int m_healthRef = 0;
@@ -269,6 +288,7 @@ protected:
     bool m_scoresLoaded = false;
     bool m_hiscoreEnabled = false;
     bool m_summaryEnabled = false;
+    bool m_rewindEnabled = false;
     bool m_paused = false;
     int m_musicMuted = false; // Note: this has to be an int
     Prompt m_prompt = PROMPT_NONE;
@@ -285,6 +305,10 @@ protected:
     int _WIDTH;
     int _HEIGHT;
     ColorMaps m_colormaps;
+    std::unique_ptr<CTintCache> m_tintCache;
+    std::unique_ptr<CBackground> m_background;
+    std::unique_ptr<CBandRenderer> m_bands;
+    uint32_t m_tintVersion = 0;
     visualStates_t m_visualStates;
     CGameUI m_ui;
     CFileWrap m_recorderFile;
@@ -305,10 +329,12 @@ protected:
     inline void drawTimeout(CFrame &bitmap);
     inline void drawKeys(CFrame &bitmap);
     inline void drawSugarMeter(CFrame &bitmap, const int bx);
-    inline void drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile, const bool alpha, const ColorMask colorMask = COLOR_NOCHANGE, std::unordered_map<uint32_t, uint32_t> *colorMap = nullptr);
-    inline void drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile, const rect_t &rect, const ColorMask colorMask = COLOR_NOCHANGE, std::unordered_map<uint32_t, uint32_t> *colorMap = nullptr);
+    inline void drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile, const bool alpha, const ColorMask colorMask = COLOR_NOCHANGE, const colorMap_t *colorMap = nullptr);
+    inline void drawTile(CFrame &bitmap, const int x, const int y, CFrame &tile, const rect_t &rect, const ColorMask colorMask = COLOR_NOCHANGE, const colorMap_t *colorMap = nullptr);
     void drawTileFaz(CFrame &bitmap, const int x, const int y, CFrame &tile, int fazBitShift = 0, const ColorMask colorMask = COLOR_NOCHANGE);
-    inline CFrame *tile2Frame(const uint8_t tileID, ColorMask &colorMask, std::unordered_map<uint32_t, uint32_t> *&colorMap);
+    static BlitEffect blitEffect(const ColorMask colorMask);
+    inline CFrame *tile2Frame(const uint8_t tileID, bool &alpha);
+    CFrame *bandFrame(const uint8_t tileID, bool &alpha, CFrame *player, const bool playerAlpha) const;
     void drawHealthBar(CFrame &bitmap, const bool isPlayerHurt);
     void drawGameStatus(CFrame &bitmap, const visualCues_t &visualcues);
     void drawScroll(CFrame &bitmap);
@@ -316,6 +342,7 @@ protected:
     void nextLevel();
     void restartLevel();
     void restartGame();
+    bool rewind(const uint32_t ticks);
     void startCountdown(int f = 1);
     int rankUserScore();
     void drawScores(CFrame &bitmap);
@@ -367,7 +394,7 @@ protected:
     virtual bool loadScores() = 0;
     virtual bool saveScores() = 0;
     virtual bool read(IFile &sfile, std::string &name);
-    virtual bool write(IFile &tfile, const std::string &name);
+    virtual bool write(IFile &tfile, const std::string &name, const bool pack = true);
     virtual void stopMusic() = 0;
     virtual void startMusic() = 0;
     virtual void setZoom(bool zoom);
@@ -389,4 +416,8 @@ private:
     void stopRecorder();
     void recordGame();
     void playbackGame();
+    void captureRewind();
+    bool readPlayState(IFile &sfile, playState_t &state);
+    void applyPlayState(const playState_t &state);
+    bool writePlayState(IFile &tfile);
 };
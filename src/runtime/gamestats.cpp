@@ -15,8 +15,20 @@
     You should have received a copy of the GNU General Public License
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include <cstring>
+#include <vector>
 #include "gamestats.h"
 #include "shared/IFile.h"
+#include "logger.h"
+#include "statehash.h"
+
+namespace GameStatsPrivate
+{
+    // key (uint16_t) + value (int32_t) as stored on disk
+    constexpr size_t ENTRY_SIZE = sizeof(uint16_t) + sizeof(int32_t);
+};
+
+using namespace GameStatsPrivate;
 
 CGameStats::CGameStats()
 {
@@ -27,63 +39,63 @@ CGameStats::~CGameStats()
 }
 
 /**
- * @brief Return a reference to the value associated with given key
+ * @brief Decrement value associated with given key. Doesn't decrement values below zero
  *
  * @param key
- * @return int&
+ * @return int& new value
  */
-int &CGameStats::get(const GameStat key)
+int &CGameStats::dec(const GameStat key)
 {
-    return m_stats[key];
+    int &value = m_stats[key];
+    if (value > 0)
+    {
+        --value;
+    }
+    return value;
 }
 
 /**
- * @brief Return value associated with given key. value returned cannot be modified
+ * @brief Increment value associated with given key.
  *
  * @param key
- * @return int
+ * @return int& new value
  */
-int CGameStats::at(const GameStat key) const
+int &CGameStats::inc(const GameStat key)
 {
-    auto it = m_stats.find(key);
-    return it != m_stats.end() ? it->second : 0;
+    return ++m_stats[key];
 }
 
 /**
- * @brief Set value associated with given key
+ * @brief Reset all values to zero
  *
- * @param key
- * @param value
  */
-void CGameStats::set(const GameStat key, int value)
+void CGameStats::clear()
 {
-    m_stats[key] = value;
+    m_stats.fill(0);
 }
 
 /**
- * @brief Decrement value associated with given key. Doesn't decrement values below zero
+ * @brief Hash of all the values (replay desync detection)
  *
- * @param key
- * @return int& new value
+ * @return uint64_t
  */
-int &CGameStats::dec(const GameStat key)
+uint64_t CGameStats::hash() const
 {
-    if (m_stats[key] > 0)
+    uint64_t h = 0;
+    for (size_t i = 0; i < m_stats.size(); ++i)
     {
-        --m_stats[key];
+        h = StateHash::combine(h, (static_cast<uint64_t>(i) << 32) | static_cast<uint32_t>(m_stats[i]));
     }
-    return m_stats[key];
+    return h;
 }
 
 /**
- * @brief Increment value associated with given key.
+ * @brief Mark all values as unchanged. Called once per frame
  *
- * @param key
- * @return int& new value
  */
-int &CGameStats::inc(const GameStat key)
+void CGameStats::clearChanged()
 {
-    return ++m_stats[key];
+    m_lastFrame = m_stats;
 }
 
 /**
@@ -128,20 +140,30 @@ template <typename ReadFunc>
 bool CGameStats::readCommon(ReadFunc readfile)
 {
     uint16_t count = 0;
-    m_stats.clear();
+    clear();
     if (!readfile(&count, sizeof(count)))
         return false;
+    if (!count)
+        return true;
+
+    // read all the entries in one go
+    std::vector<uint8_t> buf(count * ENTRY_SIZE);
+    if (!readfile(buf.data(), buf.size()))
+        return false;
 
+    const uint8_t *p = buf.data();
     for (size_t i = 0; i < count; ++i)
     {
         uint16_t key;
         int32_t value;
-
-        if (!readfile(&key, sizeof(key)))
-            return false;
-        if (!readfile(&value, sizeof(value)))
-            return false;
-
+        memcpy(&key, p, sizeof(key));
+        memcpy(&value, p + sizeof(key), sizeof(value));
+        p += ENTRY_SIZE;
+        if (key >= MAX_STATS)
+        {
+            LOGW("ignored unknown stat: 0x%.4x", key);
+            continue;
+        }
         m_stats[key] = value;
     }
     return true;
@@ -181,26 +203,20 @@ bool CGameStats::write(IFile &tfile) const
 template <typename WriteFunc>
 bool CGameStats::writeCommon(WriteFunc writefile) const
 {
+    // pack the count and the non-zero entries into a single buffer
+    std::vector<uint8_t> buf(sizeof(uint16_t) + m_stats.size() * ENTRY_SIZE);
+    uint8_t *p = buf.data() + sizeof(uint16_t);
     uint16_t count = 0;
-    for (const auto &[key, value] : m_stats)
+    for (uint16_t key = 0; key < m_stats.size(); ++key)
     {
-        if (value)
-            ++count;
+        const int32_t value = m_stats[key];
+        if (!value)
+            continue;
+        memcpy(p, &key, sizeof(key));
+        memcpy(p + sizeof(key), &value, sizeof(value));
+        p += ENTRY_SIZE;
+        ++count;
     }
-
-    if (!writefile(&count, sizeof(count)))
-        return false;
-
-    for (const auto &[key, value] : m_stats)
-    {
-        if (value)
-        {
-            if (!writefile(&key, sizeof(key)))
-                return false;
-            if (!writefile(&value, sizeof(value)))
-                return false;
-        }
-    }
-
-    return true;
-}
\ No newline at end of file
+    memcpy(buf.data(), &count, sizeof(count));
+    return writefile(buf.data(), p - buf.data());
+}
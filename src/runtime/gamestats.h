@@ -19,7 +19,7 @@
 
 #include <cstdint>
 #include <cstdio>
-#include <unordered_map>
+#include <array>
 
 class IFile;
 
@@ -43,6 +43,7 @@ enum GameStat : uint16_t
     S_SHIELD,
     S_BOAT,
     S_FLASH,
+    MAX_STATS
 };
 
 class CGameStats
@@ -51,11 +52,27 @@ public:
     CGameStats();
     ~CGameStats();
 
-    int at(const GameStat key) const;
-    int &get(const GameStat key);
-    void set(const GameStat key, int value);
+    inline int at(const GameStat key) const
+    {
+        return m_stats[key];
+    }
+    inline int &get(const GameStat key)
+    {
+        return m_stats[key];
+    }
+    inline void set(const GameStat key, int value)
+    {
+        m_stats[key] = value;
+    }
     int &dec(const GameStat key);
     int &inc(const GameStat key);
+    void clear();
+    inline bool isChanged(const GameStat key) const
+    {
+        return m_stats[key] != m_lastFrame[key];
+    }
+    void clearChanged();
+    uint64_t hash() const;
 
     [[deprecated("Use IFile interface instead")]]
     bool read(FILE *sfile);
@@ -70,5 +87,6 @@ private:
     bool writeCommon(WriteFunc writefile) const;
     template <typename ReadFunc>
     bool readCommon(ReadFunc readfile);
-    std::unordered_map<uint16_t, int32_t> m_stats;
+    std::array<int32_t, MAX_STATS> m_stats{};
+    std::array<int32_t, MAX_STATS> m_lastFrame{};
 };
\ No newline at end of file
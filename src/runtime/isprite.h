@@ -24,6 +24,7 @@
 
 #include <cstdint>
 class CActor;
+class CGame;
 class ISprite
 {
 public:
@@ -31,8 +32,8 @@ public:
     virtual int16_t x() const = 0;
     virtual int16_t y() const = 0;
     virtual uint8_t type() const = 0;
-    virtual bool canMove(const JoyAim aim) const = 0;
-    virtual void move(const JoyAim aim) = 0;
+    virtual bool canMove(const CGame &game, const JoyAim aim) const = 0;
+    virtual void move(CGame &game, const JoyAim aim) = 0;
     virtual int distance(const CActor &actor) const = 0;
     virtual void move(const int16_t x, const int16_t y) = 0;
     virtual void move(const Pos pos) = 0;
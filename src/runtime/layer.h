@@ -21,6 +21,7 @@
 #include <vector>
 #include <cstdint>
 #include <string>
+#include <utility>
 #include "dirs.h"
 #include "logger.h"
 
@@ -76,6 +77,17 @@ public:
         get(x, y) = t;
     }
 
+    // row by row, len() * hei() tiles
+    inline const uint8_t *data() const { return m_tiles.data(); }
+
+    inline void swap(CLayer &other) noexcept
+    {
+        std::swap(m_len, other.m_len);
+        std::swap(m_hei, other.m_hei);
+        m_tiles.swap(other.m_tiles);
+        m_lastError.swap(other.m_lastError);
+    }
+
     enum LayerType : uint8_t
     {
         LAYER_MAIN,
@@ -0,0 +1,55 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "map.h"
+
+struct MapReport
+{
+    int fruits;
+    int bonuses;
+    int secrets;
+};
+
+// number of cells using each tile
+using tileUsage_t = std::array<uint32_t, 256>;
+
+struct spawn_t
+{
+    Pos pos;
+    uint8_t type; // TYPE_xxx for tiles, attribute value for attribute spawns
+};
+
+/**
+ * @brief Everything CGame::loadLevel() needs to scan the map for.
+ *        Computed by CGame::buildLevelMeta() and stored by the editor
+ *        in the map archive, keyed by the CRC of the map it describes
+ *        so that a stale entry is never used.
+ */
+struct levelMeta_t
+{
+    uint32_t crc = 0;
+    Pos origin{CMap::NOT_FOUND, CMap::NOT_FOUND}; // first player tile
+    uint32_t diamonds = 0;
+    MapReport report{0, 0, 0};
+    std::vector<spawn_t> actors;     // tile monsters, row-major order
+    std::vector<spawn_t> attrSpawns; // crushers and bosses, by map key
+};
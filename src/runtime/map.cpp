@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <functional>
+#include <zlib.h>
 #include "map.h"
 #include "shared/IFile.h"
 #include "states.h"
@@ -60,7 +61,13 @@ CMap::CMap(const CMap &map) : m_len(map.m_len),
                               m_mainLayer(map.m_mainLayer),
                               m_attrs(map.m_attrs),
                               m_title(map.m_title),
-                              m_states(std::make_unique<CStates>(*map.m_states)) {}
+                              m_states(std::make_unique<CStates>(*map.m_states)),
+                              m_tileHash(map.m_tileHash),
+                              m_attrHash(map.m_attrHash),
+                              m_hashDirty(map.m_hashDirty),
+                              m_crc(map.m_crc),
+                              m_crcStates(map.m_crcStates),
+                              m_crcDirty(map.m_crcDirty) {}
 
 CMap::~CMap()
 {
@@ -74,6 +81,8 @@ void CMap::clear()
     m_len = 0;
     m_hei = 0;
     m_attrs.clear();
+    m_hashDirty = true;
+    m_crcDirty = true;
 }
 
 bool CMap::read(const char *fname)
@@ -155,6 +164,8 @@ bool CMap::read(FILE *sfile)
 template <typename ReadFunc>
 bool CMap::readImpl(ReadFunc &&readfile, std::function<size_t()> tell, std::function<bool(size_t)> seek, std::function<bool()> readStates)
 {
+    m_hashDirty = true;
+    m_crcDirty = true;
     // Read and verify signature
     char sig[sizeof(SIG)];
     if (!readfile(sig, sizeof(SIG)))
@@ -251,10 +262,9 @@ bool CMap::readImpl(ReadFunc &&readfile, std::function<size_t()> tell, std::func
             }
 
             // Read states
-            if (hdr.ver >= XTR_VER1)
+            if (hdr.ver >= XTR_VER1 && !readStates())
             {
-                // This will need adaptation based on your states read method
-                return readStates();
+                return false;
             }
         }
         else
@@ -264,6 +274,7 @@ bool CMap::readImpl(ReadFunc &&readfile, std::function<size_t()> tell, std::func
         }
     }
 
+    updateCrc();
     return true;
 }
 
@@ -420,6 +431,8 @@ void CMap::fill(uint8_t ch)
 {
     m_mainLayer.fill(ch);
     m_attrs.clear();
+    m_hashDirty = true;
+    m_crcDirty = true;
 }
 
 uint8_t CMap::getAttr(const uint8_t x, const uint8_t y) const
@@ -439,6 +452,9 @@ uint8_t CMap::getAttr(const uint8_t x, const uint8_t y) const
 void CMap::setAttr(const uint8_t x, const uint8_t y, const uint8_t a)
 {
     const uint16_t key = toKey(x, y);
+    m_crcDirty = true;
+    if (!m_hashDirty)
+        m_attrHash ^= StateHash::cell(x, y, getAttr(x, y)) ^ StateHash::cell(x, y, a);
     if (a == 0)
     {
         m_attrs.erase(key);
@@ -449,6 +465,116 @@ void CMap::setAttr(const uint8_t x, const uint8_t y, const uint8_t a)
     }
 }
 
+/**
+ * @brief Copy the tiles, row by row
+ *
+ * @param tiles receives len() * hei() tiles
+ */
+void CMap::copyTiles(std::vector<uint8_t> &tiles) const
+{
+    tiles.assign(m_mainLayer.data(), m_mainLayer.data() + m_mainLayer.size());
+}
+
+/**
+ * @brief Replace the tiles with a copy made by copyTiles(). Only the cells
+ *        that differ are written, through set(), so the tile hash is kept.
+ *
+ * @param tiles
+ * @return true
+ * @return false if the size doesn't match the map
+ */
+bool CMap::setTiles(const std::vector<uint8_t> &tiles)
+{
+    if (tiles.size() != m_mainLayer.size())
+        return false;
+    const uint8_t *current = m_mainLayer.data();
+    for (size_t i = 0; i < tiles.size(); ++i)
+    {
+        if (current[i] != tiles[i])
+            set(i % m_len, i / m_len, tiles[i]);
+    }
+    return true;
+}
+
+/**
+ * @brief CRC32 of the map content (tiles, attributes, title and states).
+ *        The value taken when the map was loaded is returned until the map
+ *        changes; after that it is hashed again on each call. Nothing is
+ *        written, so maps shared between threads can be asked for it.
+ *
+ * @return uint32_t
+ */
+uint32_t CMap::crc() const
+{
+    if (!m_crcDirty && m_crcStates == m_states->changes())
+        return m_crc;
+    return computeCrc();
+}
+
+/**
+ * @brief Hash the map again and keep the value for crc().
+ *        Called when the map is loaded; not safe while other threads read the map.
+ *
+ * @return uint32_t
+ */
+uint32_t CMap::updateCrc()
+{
+    m_crc = computeCrc();
+    m_crcStates = m_states->changes();
+    m_crcDirty = false;
+    return m_crc;
+}
+
+/**
+ * @brief Hashed in a canonical order so that the crc doesn't depend on the
+ *        order the attributes and states were inserted in
+ *
+ * @return uint32_t
+ */
+uint32_t CMap::computeCrc() const
+{
+    uLong crc = ::crc32(0L, Z_NULL, 0);
+    auto update = [&crc](const void *data, const size_t size)
+    {
+        crc = ::crc32(crc, reinterpret_cast<const Bytef *>(data), size);
+    };
+
+    update(&m_len, sizeof(m_len));
+    update(&m_hei, sizeof(m_hei));
+    std::vector<uint8_t> row(m_len);
+    for (int y = 0; y < m_hei; ++y)
+    {
+        for (int x = 0; x < m_len; ++x)
+            row[x] = at(x, y);
+        update(row.data(), row.size());
+    }
+
+    std::vector<std::pair<uint16_t, uint8_t>> attrs(m_attrs.begin(), m_attrs.end());
+    std::sort(attrs.begin(), attrs.end());
+    for (const auto &[key, a] : attrs)
+    {
+        update(&key, sizeof(key));
+        update(&a, sizeof(a));
+    }
+    update(m_title.c_str(), m_title.size() + 1);
+
+    std::vector<std::pair<uint16_t, uint16_t>> statesU(m_states->rawU().begin(), m_states->rawU().end());
+    std::sort(statesU.begin(), statesU.end());
+    for (const auto &[key, v] : statesU)
+    {
+        update(&key, sizeof(key));
+        update(&v, sizeof(v));
+    }
+    std::vector<std::pair<uint16_t, std::string>> statesS(m_states->rawS().begin(), m_states->rawS().end());
+    std::sort(statesS.begin(), statesS.end());
+    for (const auto &[key, v] : statesS)
+    {
+        update(&key, sizeof(key));
+        update(v.c_str(), v.size() + 1);
+    }
+    return crc;
+}
+
 const char *CMap::lastError()
 {
     return m_lastError.c_str();
@@ -469,10 +595,38 @@ CMap &CMap::operator=(const CMap &map)
         m_attrs = map.m_attrs;
         m_title = map.m_title;
         *m_states = *map.m_states;
+        m_tileHash = map.m_tileHash;
+        m_attrHash = map.m_attrHash;
+        m_hashDirty = map.m_hashDirty;
+        m_crc = map.m_crc;
+        m_crcStates = map.m_crcStates;
+        m_crcDirty = map.m_crcDirty;
     }
     return *this;
 }
 
+/**
+ * @brief Exchange the content of two maps without copying it
+ *
+ * @param map
+ */
+void CMap::swap(CMap &map) noexcept
+{
+    std::swap(m_len, map.m_len);
+    std::swap(m_hei, map.m_hei);
+    m_mainLayer.swap(map.m_mainLayer);
+    m_attrs.swap(map.m_attrs);
+    m_lastError.swap(map.m_lastError);
+    m_title.swap(map.m_title);
+    m_states.swap(map.m_states);
+    std::swap(m_tileHash, map.m_tileHash);
+    std::swap(m_attrHash, map.m_attrHash);
+    std::swap(m_hashDirty, map.m_hashDirty);
+    std::swap(m_crc, map.m_crc);
+    std::swap(m_crcStates, map.m_crcStates);
+    std::swap(m_crcDirty, map.m_crcDirty);
+}
+
 void CMap::shift(Direction aim)
 {
     if (m_len == 0 || m_hei == 0)
@@ -482,6 +636,8 @@ void CMap::shift(Direction aim)
     {
         return;
     }
+    m_hashDirty = true;
+    m_crcDirty = true;
 
     attrMap_t newAttrs; // New attribute map for shifted positions
 
@@ -570,6 +726,7 @@ const char *CMap::title()
 void CMap::setTitle(const char *title)
 {
     m_title = title;
+    m_crcDirty = true;
 }
 
 CStates &CMap::states()
@@ -584,6 +741,8 @@ bool CMap::resize(uint16_t in_len, uint16_t in_hei, uint8_t t, bool fast)
 
     m_len = in_len;
     m_hei = in_hei;
+    m_hashDirty = true;
+    m_crcDirty = true;
 
     if (!m_mainLayer.resize(in_hei, in_hei, t, fast))
     {
@@ -605,4 +764,49 @@ bool CMap::resize(uint16_t in_len, uint16_t in_hei, uint8_t t, bool fast)
 void CMap::replaceTile(const uint8_t src, const uint8_t repl)
 {
     m_mainLayer.replaceTile(src, repl);
+    m_hashDirty = true;
+    m_crcDirty = true;
+}
+
+/**
+ * @brief Hash of all the tiles. Maintained by set(); rebuilt after bulk changes.
+ *
+ * @return uint64_t
+ */
+uint64_t CMap::tileHash() const
+{
+    if (m_hashDirty)
+        rehash();
+    return m_tileHash;
+}
+
+/**
+ * @brief Hash of all the attributes. Maintained by setAttr(); rebuilt after bulk changes.
+ *
+ * @return uint64_t
+ */
+uint64_t CMap::attrHash() const
+{
+    if (m_hashDirty)
+        rehash();
+    return m_attrHash;
+}
+
+void CMap::rehash() const
+{
+    m_tileHash = 0;
+    for (int y = 0; y < m_hei; ++y)
+    {
+        for (int x = 0; x < m_len; ++x)
+        {
+            m_tileHash ^= StateHash::cell(x, y, at(x, y));
+        }
+    }
+    m_attrHash = 0;
+    for (const auto &[key, attr] : m_attrs)
+    {
+        const Pos pos = toPos(key);
+        m_attrHash ^= StateHash::cell(pos.x, pos.y, attr);
+    }
+    m_hashDirty = false;
 }
\ No newline at end of file
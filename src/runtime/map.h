@@ -24,6 +24,7 @@
 #include "shared/IFile.h"
 #include "dirs.h"
 #include "layer.h"
+#include "statehash.h"
 
 typedef std::unordered_map<uint16_t, uint8_t> attrMap_t;
 struct Pos
@@ -85,6 +86,7 @@ public:
     size_t size() const;
     const char *lastError();
     CMap &operator=(const CMap &map);
+    void swap(CMap &map) noexcept;
     bool fromMemory(uint8_t *mem);
     const char *title();
     void setTitle(const char *title);
@@ -102,9 +104,10 @@ public:
 
     void shift(Direction aim);
     void debug();
-    inline uint8_t &get(const int x, const int y)
+    // read only: writes go through set() so that tileHash() stays incremental
+    inline uint8_t get(const int x, const int y) const
     {
-        return m_mainLayer.get(x, y);
+        return m_mainLayer.at(x, y);
     }
 
     inline uint8_t at(const int x, const int y) const
@@ -114,9 +117,20 @@ public:
 
     inline void set(const int x, const int y, const uint8_t t)
     {
-        get(x, y) = t;
+        uint8_t &c = m_mainLayer.get(x, y);
+        m_crcDirty = true;
+        if (!m_hashDirty)
+            m_tileHash ^= StateHash::cell(x, y, c) ^ StateHash::cell(x, y, t);
+        c = t;
     }
 
+    void copyTiles(std::vector<uint8_t> &tiles) const;
+    bool setTiles(const std::vector<uint8_t> &tiles);
+    uint64_t tileHash() const;
+    uint64_t attrHash() const;
+    uint32_t crc() const;
+    uint32_t updateCrc();
+
     enum : int16_t
     {
         NOT_FOUND = -1,
@@ -135,4 +149,14 @@ private:
     std::string m_lastError;
     std::string m_title;
     std::unique_ptr<CStates> m_states;
+    // incremental hashes, rebuilt lazily after bulk changes
+    mutable uint64_t m_tileHash = 0;
+    mutable uint64_t m_attrHash = 0;
+    mutable bool m_hashDirty = true;
+    // crc kept from the last load or updateCrc(); never written by crc() itself
+    uint32_t m_crc = 0;
+    uint32_t m_crcStates = 0; // m_states->changes() when m_crc was taken
+    bool m_crcDirty = true;
+    void rehash() const;
+    uint32_t computeCrc() const;
 };
@@ -27,11 +27,15 @@ namespace MapArchPrivate
 {
     constexpr const char MAAZ_SIG[]{'M', 'A', 'A', 'Z'};
     constexpr uint16_t MAAZ_VERSION = 0;
+    // optional level metadata, after the index
+    constexpr const char META_SIG[]{'M', 'E', 'T', 'A'};
+    constexpr uint16_t META_VERSION = 0;
     enum
     {
         OFFSET_COUNT = 6,
         OFFSET_INDEX = 8,
         MAX_MAPS = 1000,
+        MAX_SPAWNS = 0x10000,
     };
 };
 
@@ -73,6 +77,7 @@ size_t CMapArch::size()
 void CMapArch::clear()
 {
     m_maps.clear();
+    m_meta.clear();
 }
 
 /**
@@ -144,7 +149,7 @@ bool CMapArch::read(IFile &file)
         return map->read(file);
     };
 
-    return readCommon(readfile, seekfile, readmap);
+    return readCommon(readfile, seekfile, readmap, true);
 }
 
 bool CMapArch::read(const char *filename)
@@ -171,13 +176,13 @@ bool CMapArch::read(const char *filename)
         return map->read(sfile);
     };
 
-    bool result = readCommon(readfile, seekfile, readmap);
+    bool result = readCommon(readfile, seekfile, readmap, true);
     fclose(sfile);
     return result;
 }
 
 template <typename ReadFunc, typename SeekFunc, typename ReadMapFunc>
-bool CMapArch::readCommon(ReadFunc readfile, SeekFunc seekfile, ReadMapFunc readmap)
+bool CMapArch::readCommon(ReadFunc readfile, SeekFunc seekfile, ReadMapFunc readmap, const bool withMeta)
 {
     Header hdr;
 
@@ -241,9 +246,135 @@ bool CMapArch::readCommon(ReadFunc readfile, SeekFunc seekfile, ReadMapFunc read
         }
         m_maps.emplace_back(std::move(map));
     }
+
+    // metadata is optional; older files end with the index
+    if (withMeta && seekfile(hdr.offset + sizeof(uint32_t) * hdr.count))
+        readMeta(readfile);
+    return true;
+}
+
+template <typename ReadFunc>
+bool CMapArch::readMeta(ReadFunc readfile)
+{
+    char sig[sizeof(META_SIG)];
+    uint16_t version = 0;
+    uint16_t count = 0;
+    if (!readfile(sig, sizeof(sig)) || memcmp(sig, META_SIG, sizeof(META_SIG)) != 0)
+        return false;
+    if (!readfile(&version, sizeof(version)) || version != META_VERSION)
+    {
+        LOGW("unsupported level metadata version: %u", version);
+        return false;
+    }
+    if (!readfile(&count, sizeof(count)) || count > MAX_MAPS)
+        return false;
+
+    auto readSpawns = [&readfile](std::vector<spawn_t> &spawns) -> bool
+    {
+        uint32_t size = 0;
+        if (!readfile(&size, sizeof(size)) || size > MAX_SPAWNS)
+            return false;
+        spawns.resize(size);
+        for (auto &spawn : spawns)
+        {
+            if (!readfile(&spawn.pos.x, sizeof(spawn.pos.x)) ||
+                !readfile(&spawn.pos.y, sizeof(spawn.pos.y)) ||
+                !readfile(&spawn.type, sizeof(spawn.type)))
+                return false;
+        }
+        return true;
+    };
+
+    for (uint16_t i = 0; i < count; ++i)
+    {
+        levelMeta_t meta;
+        int32_t report[3];
+        if (!readfile(&meta.crc, sizeof(meta.crc)) ||
+            !readfile(&meta.origin.x, sizeof(meta.origin.x)) ||
+            !readfile(&meta.origin.y, sizeof(meta.origin.y)) ||
+            !readfile(&meta.diamonds, sizeof(meta.diamonds)) ||
+            !readfile(report, sizeof(report)) ||
+            !readSpawns(meta.actors) ||
+            !readSpawns(meta.attrSpawns))
+        {
+            LOGW("level metadata truncated; ignored");
+            m_meta.clear();
+            return false;
+        }
+        meta.report = MapReport{report[0], report[1], report[2]};
+        m_meta[meta.crc] = std::move(meta);
+    }
+    return true;
+}
+
+template <typename WriteFunc>
+bool CMapArch::writeMeta(WriteFunc writefile) const
+{
+    const uint16_t count = m_meta.size();
+    if (!writefile(META_SIG, sizeof(META_SIG)) ||
+        !writefile(&META_VERSION, sizeof(META_VERSION)) ||
+        !writefile(&count, sizeof(count)))
+        return false;
+
+    auto writeSpawns = [&writefile](const std::vector<spawn_t> &spawns) -> bool
+    {
+        const uint32_t size = spawns.size();
+        if (!writefile(&size, sizeof(size)))
+            return false;
+        for (const auto &spawn : spawns)
+        {
+            if (!writefile(&spawn.pos.x, sizeof(spawn.pos.x)) ||
+                !writefile(&spawn.pos.y, sizeof(spawn.pos.y)) ||
+                !writefile(&spawn.type, sizeof(spawn.type)))
+                return false;
+        }
+        return true;
+    };
+
+    for (const auto &[crc, meta] : m_meta)
+    {
+        const int32_t report[3] = {meta.report.fruits, meta.report.bonuses, meta.report.secrets};
+        if (!writefile(&meta.crc, sizeof(meta.crc)) ||
+            !writefile(&meta.origin.x, sizeof(meta.origin.x)) ||
+            !writefile(&meta.origin.y, sizeof(meta.origin.y)) ||
+            !writefile(&meta.diamonds, sizeof(meta.diamonds)) ||
+            !writefile(report, sizeof(report)) ||
+            !writeSpawns(meta.actors) ||
+            !writeSpawns(meta.attrSpawns))
+            return false;
+    }
     return true;
 }
 
+/**
+ * @brief Get the precomputed metadata for a map. The lookup key is the
+ *        map's crc, which CMap takes when the map is loaded or saved.
+ *
+ * @param map
+ * @return const levelMeta_t* nullptr if none matches the map's content
+ */
+const levelMeta_t *CMapArch::meta(const CMap &map) const
+{
+    if (m_meta.empty())
+        return nullptr;
+    auto it = m_meta.find(map.crc());
+    return it != m_meta.end() ? &it->second : nullptr;
+}
+
+/**
+ * @brief Store the metadata of a map; written with the archive
+ *
+ * @param map
+ * @param meta
+ */
+void CMapArch::setMeta(const CMap &map, const levelMeta_t &meta)
+{
+    const uint32_t crc = map.crc();
+    levelMeta_t &entry = m_meta[crc];
+    entry = meta;
+    entry.crc = crc;
+}
+
 /**
  * @brief Write file to disk
  *
@@ -277,6 +408,14 @@ bool CMapArch::write(const char *filename)
             long ptr = index[i];
             fwrite(&ptr, 4, 1, tfile);
         }
+        if (!m_meta.empty())
+        {
+            auto writefile = [tfile](const void *ptr, size_t size) -> bool
+            {
+                return fwrite(ptr, size, 1, tfile) == 1;
+            };
+            writeMeta(writefile);
+        }
         // write version
         fseek(tfile, 4, SEEK_SET);
         fwrite(&MAAZ_VERSION, 2, 1, tfile);
@@ -492,6 +631,7 @@ bool CMapArch::indexFromMemory(uint8_t *ptr, IndexVector &index)
 void CMapArch::removeAll()
 {
     m_maps.clear();
+    m_meta.clear();
 }
 
 /**
@@ -522,5 +662,6 @@ bool CMapArch::fromMemory(uint8_t *ptr)
         return map->fromMemory(ptr);
     };
 
-    return readCommon(copyData, seekmem, readmap);
+    // the blob size is unknown: don't probe for metadata past the index
+    return readCommon(copyData, seekmem, readmap, false);
 }
\ No newline at end of file
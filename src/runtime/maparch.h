@@ -20,6 +20,8 @@
 #include <string>
 #include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include "levelmeta.h"
 
 class IFile;
 class CMap;
@@ -48,10 +50,18 @@ public:
     static bool indexFromFile(const char *filename, IndexVector &index);
     static bool indexFromMemory(uint8_t *ptr, IndexVector &index);
     bool fromMemory(uint8_t *ptr);
+    const levelMeta_t *meta(const CMap &map) const;
+    void setMeta(const CMap &map, const levelMeta_t &meta);
+    void clearMeta() { m_meta.clear(); }
 
 protected:
     template <typename ReadFunc, typename SeekFunc, typename ReadMapFunc>
-    bool readCommon(ReadFunc readfile, SeekFunc seekfile, ReadMapFunc readmap);
+    bool readCommon(ReadFunc readfile, SeekFunc seekfile, ReadMapFunc readmap, const bool withMeta);
+    template <typename ReadFunc>
+    bool readMeta(ReadFunc readfile);
+    template <typename WriteFunc>
+    bool writeMeta(WriteFunc writefile) const;
     std::vector<std::unique_ptr<CMap>> m_maps;
+    std::unordered_map<uint32_t, levelMeta_t> m_meta;
     std::string m_lastError;
 };
@@ -0,0 +1,86 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "prefetch.h"
+#include "maparch.h"
+#include "game.h"
+#include "logger.h"
+
+CLevelPrefetch::~CLevelPrefetch()
+{
+    cancel();
+}
+
+/**
+ * @brief Start preparing a level in the background.
+ *        Replaces any level previously requested.
+ *
+ * @param arch
+ * @param level
+ */
+void CLevelPrefetch::request(CMapArch *arch, const int level)
+{
+    if (m_level == level && m_staging.valid())
+        return;
+    cancel();
+    if (arch == nullptr || arch->at(level) == nullptr)
+        return;
+    m_level = level;
+    // the map is copied here, so the worker only has its own copy to scan
+    auto staging = std::make_unique<staging_t>(staging_t{*arch->at(level), {}});
+    m_staging = std::async(std::launch::async, prepare, arch, std::move(staging));
+}
+
+/**
+ * @brief Retrieve the staged level, waiting for the worker if needed
+ *
+ * @param level expected level
+ * @param map receives the level map (swapped in)
+ * @param meta receives the level metadata
+ * @return true
+ * @return false if another level (or none) was staged; it is kept
+ */
+bool CLevelPrefetch::take(const int level, CMap &map, levelMeta_t &meta)
+{
+    if (m_level != level || !m_staging.valid())
+        return false;
+    std::unique_ptr<staging_t> staging = m_staging.get();
+    m_level = NONE;
+    map.swap(staging->map);
+    meta = std::move(staging->meta);
+    return true;
+}
+
+/**
+ * @brief Drop the staged level
+ *
+ */
+void CLevelPrefetch::cancel()
+{
+    // the worker can't be interrupted: wait for it
+    if (m_staging.valid())
+        m_staging.wait();
+    m_staging = {};
+    m_level = NONE;
+}
+
+std::unique_ptr<CLevelPrefetch::staging_t> CLevelPrefetch::prepare(const CMapArch *arch, std::unique_ptr<staging_t> staging)
+{
+    const levelMeta_t *cached = arch->meta(staging->map);
+    staging->meta = cached ? *cached : CGame::buildLevelMeta(staging->map);
+    return staging;
+}
@@ -0,0 +1,61 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <future>
+#include <memory>
+#include "map.h"
+#include "levelmeta.h"
+
+class CMapArch;
+
+/**
+ * @brief Prepares a level on a worker thread while the current one is
+ *        being played.
+ *
+ * The staging slot holds a private copy of the archive map and its level
+ * metadata, so taking it is a swap instead of a copy and a scan. The copy
+ * is made by the caller: the worker never touches the archive maps.
+ */
+class CLevelPrefetch
+{
+public:
+    CLevelPrefetch() = default;
+    ~CLevelPrefetch();
+
+    void request(CMapArch *arch, const int level);
+    bool take(const int level, CMap &map, levelMeta_t &meta);
+    void cancel();
+    inline int pending() const { return m_level; }
+
+    enum : int
+    {
+        NONE = -1,
+    };
+
+private:
+    struct staging_t
+    {
+        CMap map;
+        levelMeta_t meta;
+    };
+
+    int m_level = NONE;
+    std::future<std::unique_ptr<staging_t>> m_staging;
+    static std::unique_ptr<staging_t> prepare(const CMapArch *arch, std::unique_ptr<staging_t> staging);
+};
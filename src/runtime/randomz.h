@@ -37,6 +37,9 @@ public:
     // Reset to initial seed and tick
     void reset();
 
+    // Internal state (for state hashing)
+    uint64_t state() const { return (static_cast<uint64_t>(tick_) << 32) | state_; }
+
 private:
     uint32_t state_;
     uint32_t initialSeed_;
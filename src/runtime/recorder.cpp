@@ -48,6 +48,12 @@ bool CRecorder::start(IFile *file, bool isWrite)
     m_index = 0;
     m_count = 0;
     m_size = 0;
+    m_batchSize = 0;
+    m_ticks = 0;
+    m_hasCheckpoint = false;
+    m_checkpoints = 0;
+    m_divergedTick = 0;
+    m_divergedPart = stateHash_t::MAX_PARTS;
 
     m_mode = isWrite ? MODE_WRITE : MODE_READ;
     m_file = file;
@@ -75,9 +81,9 @@ bool CRecorder::start(IFile *file, bool isWrite)
             return false;
         }
         readFile(&version, sizeof(version));
-        if (version != VERSION)
+        if (version > VERSION)
         {
-            LOGE("version mismatch: 0x%.8x; expecting :0x%.8x\n", version, VERSION);
+            LOGE("version mismatch: 0x%.8x; expecting <= 0x%.8x\n", version, VERSION);
             return false;
         }
         readFile(&m_size, sizeof(m_size)); // total datasize of data
@@ -104,6 +110,7 @@ bool CRecorder::readNextBatch()
 
 void CRecorder::append(const uint8_t *input)
 {
+    ++m_ticks;
     // encode input
     uint8_t data = 0;
     for (int i = 0; i < INPUTS; ++i)
@@ -144,6 +151,68 @@ void CRecorder::storeData(bool finalize)
     }
 }
 
+void CRecorder::storeByte(const uint8_t data)
+{
+    m_buffer[m_index++] = data;
+    if (m_index == m_bufSize)
+        dump();
+}
+
+/**
+ * @brief True when a checkpoint is due before the next input is appended
+ *
+ * @return true
+ * @return false
+ */
+bool CRecorder::wantsCheckpoint() const
+{
+    return m_mode == MODE_WRITE && m_hashInterval != 0 && m_ticks % m_hashInterval == 0;
+}
+
+/**
+ * @brief Store the state hash for the current tick in the stream.
+ *        The pending run is closed first so that the checkpoint sits
+ *        exactly between two inputs.
+ *
+ * @param hash
+ */
+void CRecorder::appendCheckpoint(const stateHash_t &hash)
+{
+    storeData(false);
+    m_newInfo = true;
+    uint8_t data[CHECKPOINT_SIZE];
+    data[0] = MARKER_CHECKPOINT;
+    memcpy(data + 1, &m_ticks, sizeof(m_ticks));
+    memcpy(data + 1 + sizeof(m_ticks), hash.parts, sizeof(hash.parts));
+    for (size_t i = 0; i < sizeof(data); ++i)
+        storeByte(data[i]);
+}
+
+/**
+ * @brief Compare the pending checkpoint against the current state.
+ *        The first divergence is logged and kept.
+ *
+ * @param hash current state
+ * @return true if the state matches
+ */
+bool CRecorder::verify(const stateHash_t &hash)
+{
+    if (!m_hasCheckpoint)
+        return true;
+    m_hasCheckpoint = false;
+    ++m_checkpoints;
+    const int part = m_checkpoint.diff(hash);
+    if (part == stateHash_t::MAX_PARTS)
+        return true;
+    if (!diverged())
+    {
+        m_divergedTick = m_checkpointTick;
+        m_divergedPart = part;
+        LOGW("replay desync at tick %u: %s\n", m_checkpointTick, stateHash_t::partName(part));
+    }
+    return false;
+}
+
 void CRecorder::dump()
 {
     if (m_index)
@@ -155,38 +224,64 @@ void CRecorder::dump()
     m_index = 0;
 }
 
-void CRecorder::nextData()
+bool CRecorder::nextByte(uint8_t &data)
 {
-    const uint8_t data = m_buffer[m_index++];
-    m_current = data & MAX_CPT;
-    m_count = data >> 4;
+    // fetch next batch from disk
+    if (m_index == m_batchSize)
+    {
+        if (m_size == 0 || !readNextBatch())
+            return false;
+    }
+    data = m_buffer[m_index++];
+    return true;
 }
 
-bool CRecorder::get(uint8_t *output)
+bool CRecorder::readCheckpoint()
 {
-    if (m_newInfo)
+    uint8_t data[CHECKPOINT_SIZE - 1];
+    for (size_t i = 0; i < sizeof(data); ++i)
     {
-        nextData();
-        m_newInfo = false;
-        --m_count;
-    }
-    else if (m_count != 0)
-    {
-        --m_count;
+        if (!nextByte(data[i]))
+            return false;
     }
-    else
+    memcpy(&m_checkpointTick, data, sizeof(m_checkpointTick));
+    memcpy(m_checkpoint.parts, data + sizeof(m_checkpointTick), sizeof(m_checkpoint.parts));
+    m_hasCheckpoint = true;
+    return true;
+}
+
+bool CRecorder::nextData()
+{
+    uint8_t data = 0;
+    while (true)
     {
-        // fetch next batch from disk
-        if (m_index == m_batchSize)
+        if (!nextByte(data))
+            return false;
+        if (data >> 4)
+            break;
+        if (data != MARKER_CHECKPOINT)
         {
-            if (m_size != 0)
-                readNextBatch();
-            else
-                return false;
+            LOGE("CRecorder: invalid marker 0x%.2x\n", data);
+            return false;
         }
-        nextData();
-        --m_count;
+        if (!readCheckpoint())
+            return false;
+    }
+    m_current = data & MAX_CPT;
+    m_count = data >> 4;
+    return true;
+}
+
+bool CRecorder::get(uint8_t *output)
+{
+    if (m_newInfo || m_count == 0)
+    {
+        if (!nextData())
+            return false;
+        m_newInfo = false;
     }
+    --m_count;
+    ++m_ticks;
     decode(output, m_current);
     return true;
 }
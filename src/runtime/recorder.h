@@ -20,6 +20,7 @@
 #include <cinttypes>
 #include <cstdio>
 #include "shared/IFile.h"
+#include "statehash.h"
 
 class CRecorder
 {
@@ -34,6 +35,18 @@ public:
     bool isRecording() const;
     bool isReading() const;
     bool isStopped() const;
+    uint32_t ticks() const { return m_ticks; }
+
+    // state hash checkpoints (replay desync detection)
+    void setHashInterval(const uint32_t interval) { m_hashInterval = interval; }
+    bool wantsCheckpoint() const;
+    void appendCheckpoint(const stateHash_t &hash);
+    bool hasCheckpoint() const { return m_hasCheckpoint; }
+    bool verify(const stateHash_t &hash);
+    bool diverged() const { return m_divergedPart != stateHash_t::MAX_PARTS; }
+    uint32_t divergedTick() const { return m_divergedTick; }
+    int divergedPart() const { return m_divergedPart; }
+    uint32_t checkpoints() const { return m_checkpoints; }
 
 private:
     enum
@@ -44,7 +57,10 @@ private:
         MODE_CLOSED = 0,
         MODE_READ = 1,
         MODE_WRITE = 2,
-        VERSION = 0,
+        VERSION = 1,
+        // bytes with a zero count are markers
+        MARKER_CHECKPOINT = 0x01,
+        CHECKPOINT_SIZE = 1 + sizeof(uint32_t) + sizeof(stateHash_t::parts),
     };
     uint8_t m_mode;
     bool m_newInfo = true;
@@ -57,10 +73,21 @@ private:
     size_t m_bufSize;
     IFile *m_file = nullptr;
     size_t m_offset;
+    uint32_t m_ticks = 0;
+    uint32_t m_hashInterval = 0;
+    bool m_hasCheckpoint = false;
+    uint32_t m_checkpointTick = 0;
+    stateHash_t m_checkpoint;
+    uint32_t m_checkpoints = 0;
+    uint32_t m_divergedTick = 0;
+    int m_divergedPart = stateHash_t::MAX_PARTS;
 
     void decode(uint8_t *output, uint8_t data);
     void storeData(bool finalize);
     void dump();
     bool readNextBatch();
-    void nextData();
+    bool nextData();
+    bool nextByte(uint8_t &data);
+    void storeByte(const uint8_t data);
+    bool readCheckpoint();
 };
\ No newline at end of file
@@ -0,0 +1,274 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cstring>
+#include "rewind.h"
+#include "logger.h"
+
+namespace RewindPrivate
+{
+    // shortest run of zero bytes worth ending a literal
+    constexpr size_t MIN_ZERO_RUN = 3;
+
+    inline void putVarint(std::vector<uint8_t> &out, size_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(v) | 0x80);
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    inline bool getVarint(const std::vector<uint8_t> &in, size_t &i, size_t &v)
+    {
+        v = 0;
+        for (int shift = 0; i < in.size() && shift < 64; shift += 7)
+        {
+            const uint8_t b = in[i++];
+            v |= static_cast<size_t>(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return true;
+        }
+        return false;
+    }
+};
+
+using namespace RewindPrivate;
+
+CRewind::CRewind(const size_t budget, const uint32_t keyInterval) : m_budget(budget), m_keyInterval(keyInterval ? keyInterval : 1)
+{
+}
+
+void CRewind::clear()
+{
+    m_frames.clear();
+    m_memory = 0;
+    m_sinceKey = 0;
+}
+
+/**
+ * @brief Store the snapshot for a given tick. Ticks must be increasing.
+ *
+ * @param tick
+ * @param map map plane
+ * @param actors actors plane
+ */
+void CRewind::push(const uint32_t tick, const std::vector<uint8_t> &map, const std::vector<uint8_t> &actors)
+{
+    if (!m_frames.empty() && tick <= m_frames.back().tick)
+    {
+        if (tick == 0)
+            clear();
+        else
+            discardAfter(tick - 1);
+    }
+
+    const frame_t *key = lastKey();
+    const std::vector<uint8_t> *planes[PLANE_COUNT] = {&map, &actors};
+    frame_t frame{tick, key == nullptr || m_sinceKey >= m_keyInterval, {}, {}};
+    for (int i = 0; i < PLANE_COUNT; ++i)
+    {
+        frame.size[i] = static_cast<uint32_t>(planes[i]->size());
+        if (frame.key)
+            frame.data[i] = *planes[i];
+        else
+            encode(key->data[i], *planes[i], frame.data[i]);
+    }
+    if (frame.key)
+        m_sinceKey = 0;
+    ++m_sinceKey;
+    m_memory += frame.memory();
+    m_frames.emplace_back(std::move(frame));
+    trim();
+}
+
+/**
+ * @brief Rebuild the snapshot for the newest tick not above the requested one
+ *
+ * @param tick
+ * @param map receives the map plane
+ * @param actors receives the actors plane
+ * @return true
+ * @return false if the tick is older than the window
+ */
+bool CRewind::restore(const uint32_t tick, std::vector<uint8_t> &map, std::vector<uint8_t> &actors) const
+{
+    const size_t i = frameAt(tick);
+    if (i == m_frames.size())
+        return false;
+    const frame_t &frame = m_frames[i];
+    if (frame.key)
+    {
+        map = frame.data[PLANE_MAP];
+        actors = frame.data[PLANE_ACTORS];
+        return true;
+    }
+    size_t k = i;
+    while (k > 0 && !m_frames[k].key)
+        --k;
+    const frame_t &key = m_frames[k];
+    if (!key.key)
+        return false;
+    return decode(key.data[PLANE_MAP], frame.data[PLANE_MAP], frame.size[PLANE_MAP], frame.tick, map) &&
+           decode(key.data[PLANE_ACTORS], frame.data[PLANE_ACTORS], frame.size[PLANE_ACTORS], frame.tick, actors);
+}
+
+/**
+ * @brief Drop every snapshot newer than tick (after a restore)
+ *
+ * @param tick
+ */
+void CRewind::discardAfter(const uint32_t tick)
+{
+    while (!m_frames.empty() && m_frames.back().tick > tick)
+    {
+        m_memory -= m_frames.back().memory();
+        m_frames.pop_back();
+    }
+    // count the deltas since the last remaining keyframe
+    m_sinceKey = 0;
+    for (auto it = m_frames.rbegin(); it != m_frames.rend(); ++it)
+    {
+        ++m_sinceKey;
+        if (it->key)
+            break;
+    }
+}
+
+const CRewind::frame_t *CRewind::lastKey() const
+{
+    for (auto it = m_frames.rbegin(); it != m_frames.rend(); ++it)
+    {
+        if (it->key)
+            return &*it;
+    }
+    return nullptr;
+}
+
+size_t CRewind::frameAt(const uint32_t tick) const
+{
+    // newest frame with frame.tick <= tick
+    size_t lo = 0;
+    size_t hi = m_frames.size();
+    while (lo < hi)
+    {
+        const size_t mid = (lo + hi) / 2;
+        if (m_frames[mid].tick <= tick)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo == 0 ? m_frames.size() : lo - 1;
+}
+
+void CRewind::trim()
+{
+    // drop whole keyframe groups, always keeping the current one
+    while (m_memory > m_budget)
+    {
+        size_t next = 1;
+        while (next < m_frames.size() && !m_frames[next].key)
+            ++next;
+        if (next == m_frames.size())
+            break;
+        for (size_t i = 0; i < next; ++i)
+        {
+            m_memory -= m_frames.front().memory();
+            m_frames.pop_front();
+        }
+    }
+}
+
+/**
+ * @brief XOR state against key, then encode as (zero run, literal) pairs
+ *
+ * @param key plane of the keyframe
+ * @param state same plane of the snapshot
+ * @param out delta
+ */
+void CRewind::encode(const std::vector<uint8_t> &key, const std::vector<uint8_t> &state, std::vector<uint8_t> &out)
+{
+    const size_t size = state.size();
+    auto xorAt = [&key, &state](const size_t i) -> uint8_t
+    {
+        return i < key.size() ? state[i] ^ key[i] : state[i];
+    };
+
+    out.clear();
+    size_t i = 0;
+    while (i < size)
+    {
+        const size_t zeroStart = i;
+        while (i < size && xorAt(i) == 0)
+            ++i;
+        putVarint(out, i - zeroStart);
+
+        const size_t litStart = i;
+        size_t zeros = 0;
+        while (i < size)
+        {
+            zeros = xorAt(i) == 0 ? zeros + 1 : 0;
+            ++i;
+            if (zeros == MIN_ZERO_RUN)
+            {
+                i -= zeros;
+                break;
+            }
+        }
+        if (i == size)
+        {
+            // don't carry trailing zeros in the literal
+            while (i > litStart && xorAt(i - 1) == 0)
+                --i;
+        }
+        putVarint(out, i - litStart);
+        for (size_t j = litStart; j < i; ++j)
+            out.push_back(xorAt(j));
+        if (i == litStart)
+            break;
+    }
+    out.shrink_to_fit();
+}
+
+bool CRewind::decode(const std::vector<uint8_t> &key, const std::vector<uint8_t> &in, const uint32_t size, const uint32_t tick, std::vector<uint8_t> &out)
+{
+    out.resize(size);
+    const size_t common = std::min<size_t>(size, key.size());
+    memcpy(out.data(), key.data(), common);
+    if (size > common)
+        memset(out.data() + common, 0, size - common);
+
+    size_t i = 0;
+    size_t pos = 0;
+    while (i < in.size())
+    {
+        size_t zeros = 0;
+        size_t lits = 0;
+        if (!getVarint(in, i, zeros) || !getVarint(in, i, lits) ||
+            pos + zeros + lits > size || i + lits > in.size())
+        {
+            LOGE("CRewind: corrupted delta for tick %u", tick);
+            return false;
+        }
+        pos += zeros;
+        for (size_t j = 0; j < lits; ++j)
+            out[pos++] ^= in[i++];
+    }
+    return true;
+}
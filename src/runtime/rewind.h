@@ -0,0 +1,84 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Ring buffer of game snapshots, split in two planes: the map
+ *        tiles and the actors (everything else a session needs, which is
+ *        small).
+ *
+ * Every keyInterval pushes, both planes are stored raw as a keyframe;
+ * the snapshots in between keep each plane as the XOR against the
+ * keyframe, run-length encoded on the zero bytes. Restoring a tick decodes
+ * a single delta. The oldest keyframe groups are dropped when the memory
+ * budget is exceeded.
+ */
+class CRewind
+{
+public:
+    enum : uint32_t
+    {
+        DEFAULT_BUDGET = 8 * 1024 * 1024,
+        KEY_INTERVAL = 48,
+    };
+
+    CRewind(const size_t budget = DEFAULT_BUDGET, const uint32_t keyInterval = KEY_INTERVAL);
+    ~CRewind() {};
+
+    void clear();
+    void push(const uint32_t tick, const std::vector<uint8_t> &map, const std::vector<uint8_t> &actors);
+    bool restore(const uint32_t tick, std::vector<uint8_t> &map, std::vector<uint8_t> &actors) const;
+    void discardAfter(const uint32_t tick);
+    inline bool empty() const { return m_frames.empty(); }
+    inline uint32_t oldest() const { return m_frames.empty() ? 0 : m_frames.front().tick; }
+    inline uint32_t newest() const { return m_frames.empty() ? 0 : m_frames.back().tick; }
+    inline size_t memoryUsage() const { return m_memory; }
+
+private:
+    enum Plane : uint8_t
+    {
+        PLANE_MAP,
+        PLANE_ACTORS,
+        PLANE_COUNT,
+    };
+
+    struct frame_t
+    {
+        uint32_t tick;
+        bool key;
+        uint32_t size[PLANE_COUNT]; // decoded sizes
+        std::vector<uint8_t> data[PLANE_COUNT];
+        size_t memory() const { return sizeof(frame_t) + data[PLANE_MAP].size() + data[PLANE_ACTORS].size(); }
+    };
+
+    std::deque<frame_t> m_frames;
+    size_t m_budget;
+    size_t m_memory = 0;
+    uint32_t m_keyInterval;
+    uint32_t m_sinceKey = 0;
+    const frame_t *lastKey() const;
+    size_t frameAt(const uint32_t tick) const;
+    void trim();
+    static void encode(const std::vector<uint8_t> &key, const std::vector<uint8_t> &state, std::vector<uint8_t> &out);
+    static bool decode(const std::vector<uint8_t> &key, const std::vector<uint8_t> &in, const uint32_t size, const uint32_t tick, std::vector<uint8_t> &out);
+};
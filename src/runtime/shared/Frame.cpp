@@ -30,6 +30,7 @@
 #include "CRC.h"
 #include "IFile.h"
 #include "helper.h"
+#include "Upscale.h"
 #include <cstdint>
 #include "logger.h"
 #include "ss_limits.h"
@@ -295,24 +296,14 @@ uint32_t CFrame::toNet(const uint32_t a)
     return b;
 }
 
-bool CFrame::toPng(std::vector<uint8_t> &png, const std::vector<uint8_t> &obl5data)
+bool CFrame::toPng(std::vector<uint8_t> &png, const std::vector<uint8_t> &obl5data, const pngOptions_t &options)
 {
     png.clear();
     CCRC crc;
 
-    // compress the data ....................................
-    int scanLine = m_width * 4;
-    uLong dataSize = (scanLine + 1) * m_height;
-    std::vector<uint8_t> rdata(dataSize);
-    for (int y = 0; y < m_height; ++y)
-    {
-        uint8_t *d = rdata.data() + y * (scanLine + 1);
-        *d = 0;
-        memcpy(d + 1, m_rgb.data() + y * m_width, scanLine);
-    }
-
+    // filter and compress the data ....................................
     std::vector<uint8_t> cData;
-    int err = compressData(rdata, cData);
+    int err = deflateImage(m_rgb.data(), m_width, m_height, cData, options);
     if (err != Z_OK)
     {
         m_lastError = "Zlib decompression error " + std::to_string(err) + ": " + zError(err);
@@ -347,7 +338,7 @@ bool CFrame::toPng(std::vector<uint8_t> &png, const std::vector<uint8_t> &obl5da
     ihdr.BitDepth = 8;
     ihdr.ColorType = 6;
     ihdr.Compression = 0; // deflated
-    ihdr.Filter = 0;
+    ihdr.Filter = 0; // method 0: a filter type per row
     ihdr.Interlace = 0;
     // ihdr.CRC = 0;
     t += png_IHDR_Size;
@@ -747,19 +738,8 @@ void CFrame::shrink()
 void CFrame::enlarge()
 {
     CFrame newFrame(m_width * 2, m_height * 2);
-    for (int y = 0; y < m_height; ++y)
-    {
-        for (int x = 0; x < m_width; ++x)
-        {
-            uint32_t c = at(x, y);
-            newFrame.at(x * 2, y * 2) = c;
-            newFrame.at(x * 2 + 1, y * 2) = c;
-            newFrame.at(x * 2, y * 2 + 1) = c;
-            newFrame.at(x * 2 + 1, y * 2 + 1) = c;
-        }
-    }
-
-    m_rgb = newFrame.getRGB();
+    upscale(m_rgb.data(), m_width, newFrame.getRGB().data(), newFrame.width(), m_width, m_height, 2);
+    m_rgb = std::move(newFrame.getRGB());
 
     m_width *= 2;
     m_height *= 2;
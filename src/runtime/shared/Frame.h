@@ -21,6 +21,7 @@
 #include <vector>
 #include <stdexcept>
 #include "DotArray.h"
+#include "PngEncoder.h"
 
 class CFrameSet;
 class CDotArray;
@@ -96,7 +97,7 @@ public:
     bool write(IFile &file);
 
     void toBmp(uint8_t *&bmp, int &size);
-    bool toPng(std::vector<uint8_t> &png, const std::vector<uint8_t> &obl5data = {});
+    bool toPng(std::vector<uint8_t> &png, const std::vector<uint8_t> &obl5data = {}, const pngOptions_t &options = {});
 
     static uint32_t toNet(const uint32_t a);
     bool draw(const std::vector<Dot> &dots, const int penSize, const int mode = MODE_NORMAL);
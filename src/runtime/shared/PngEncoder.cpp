@@ -0,0 +1,241 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <zlib.h>
+#include "PngEncoder.h"
+
+namespace PngEncoderPrivate
+{
+    enum : int
+    {
+        FILTER_NONE,
+        FILTER_SUB,
+        FILTER_UP,
+        FILTER_AVERAGE,
+        FILTER_PAETH,
+        FILTER_COUNT,
+        BPP = 4,                  // bytes per pixel
+        WINDOW_SIZE = 32768,      // deflate window, primed from the previous stripe
+        MIN_STRIPE = 256 * 1024,  // filtered bytes per stripe, at least
+        MAX_JOBS = 16,
+    };
+
+    // branch-free so the row loops vectorize
+    inline uint8_t paeth(const int a, const int b, const int c)
+    {
+        const int p = b - c;
+        const int q = a - c;
+        const int pa = std::abs(p);
+        const int pb = std::abs(q);
+        const int pc = std::abs(p + q);
+        const int ab = pa <= pb ? a : b;
+        const int abc = std::min(pa, pb) <= pc ? ab : c;
+        return static_cast<uint8_t>(abc);
+    }
+
+    void filterRow(const uint8_t *row, const uint8_t *prev, const int size, const int type, uint8_t *out)
+    {
+        switch (type)
+        {
+        case FILTER_NONE:
+            memcpy(out, row, size);
+            break;
+        case FILTER_SUB:
+            memcpy(out, row, BPP);
+            for (int i = BPP; i < size; ++i)
+                out[i] = row[i] - row[i - BPP];
+            break;
+        case FILTER_UP:
+            for (int i = 0; i < size; ++i)
+                out[i] = row[i] - prev[i];
+            break;
+        case FILTER_AVERAGE:
+            for (int i = 0; i < BPP; ++i)
+                out[i] = row[i] - (prev[i] >> 1);
+            for (int i = BPP; i < size; ++i)
+                out[i] = row[i] - ((row[i - BPP] + prev[i]) >> 1);
+            break;
+        case FILTER_PAETH:
+            for (int i = 0; i < BPP; ++i)
+                out[i] = row[i] - prev[i];
+            for (int i = BPP; i < size; ++i)
+                out[i] = row[i] - paeth(row[i - BPP], prev[i], prev[i - BPP]);
+            break;
+        }
+    }
+
+    // pixels that differ from their left neighbour: runs are what deflate
+    // matches best in pixel art, where the usual sum of residuals grows files
+    uint32_t cost(const uint8_t *data, const int size)
+    {
+        uint32_t sum = 0;
+        uint32_t last = 0;
+        for (int i = 0; i < size; i += BPP)
+        {
+            uint32_t pixel;
+            memcpy(&pixel, data + i, sizeof(pixel));
+            sum += pixel != last;
+            last = pixel;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Raw deflate of one stripe, ending on a byte boundary
+     *
+     * @param data stripe
+     * @param size
+     * @param dict what comes right before the stripe, nullptr for the first
+     * @param dictSize
+     * @param last ends the stream rather than flushing
+     * @param level
+     * @param out
+     * @return int zlib error
+     */
+    int deflateStripe(const uint8_t *data, const size_t size, const uint8_t *dict, const size_t dictSize, const bool last, const int level, std::vector<uint8_t> &out)
+    {
+        z_stream strm{};
+        int err = deflateInit2(&strm, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        if (err != Z_OK)
+            return err;
+        if (dict && dictSize)
+            deflateSetDictionary(&strm, dict, static_cast<uInt>(dictSize));
+        out.resize(deflateBound(&strm, size) + 16);
+        strm.next_in = const_cast<uint8_t *>(data);
+        strm.avail_in = static_cast<uInt>(size);
+        const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+        const int done = last ? Z_STREAM_END : Z_OK;
+        do
+        {
+            if (strm.total_out == out.size())
+                out.resize(out.size() * 2);
+            strm.next_out = out.data() + strm.total_out;
+            strm.avail_out = static_cast<uInt>(out.size() - strm.total_out);
+            err = deflate(&strm, flush);
+        } while ((err == Z_OK || err == Z_BUF_ERROR) && (last ? err != Z_STREAM_END : strm.avail_out == 0));
+        out.resize(strm.total_out);
+        deflateEnd(&strm);
+        return err == done ? Z_OK : err;
+    }
+
+    void putBigEndian(std::vector<uint8_t> &out, const uint32_t v)
+    {
+        const uint8_t b[] = {uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v)};
+        out.insert(out.end(), b, b + sizeof(b));
+    }
+};
+
+using namespace PngEncoderPrivate;
+
+void filterRows(const uint8_t *rgba, const int width, const int first, const int last, uint8_t *out, const bool adaptive)
+{
+    const int size = width * BPP;
+    std::vector<uint8_t> zero(size, 0);
+    std::vector<uint8_t> trial(adaptive ? size : 0);
+    for (int y = first; y < last; ++y, out += size + 1)
+    {
+        const uint8_t *row = rgba + size_t(y) * size;
+        const uint8_t *prev = y ? row - size : zero.data();
+        int best = FILTER_NONE;
+        if (adaptive)
+        {
+            // a filter has to halve the changes to beat the raw row
+            uint32_t bestCost = cost(row, size) / 2;
+            for (int type = FILTER_SUB; type < FILTER_COUNT; ++type)
+            {
+                filterRow(row, prev, size, type, trial.data());
+                const uint32_t c = cost(trial.data(), size);
+                if (c < bestCost)
+                {
+                    bestCost = c;
+                    best = type;
+                }
+            }
+        }
+        out[0] = static_cast<uint8_t>(best);
+        filterRow(row, prev, size, best, out + 1);
+    }
+}
+
+int deflateImage(const uint32_t *rgba, const int width, const int height, std::vector<uint8_t> &out, const pngOptions_t &options)
+{
+    const size_t pitch = size_t(width) * BPP + 1;
+    const size_t total = pitch * height;
+    const uint8_t *pixels = reinterpret_cast<const uint8_t *>(rgba);
+
+    unsigned jobs = options.jobs ? options.jobs : std::thread::hardware_concurrency();
+    jobs = std::clamp<unsigned>(jobs, 1, MAX_JOBS);
+    const int stripes = std::max(1, std::min<int>(std::min<int>(jobs, height), static_cast<int>(total / MIN_STRIPE)));
+    auto firstRow = [height, stripes](const int i)
+    { return static_cast<int>(int64_t(height) * i / stripes); };
+
+    // filter the stripes, then deflate each one primed with the end of the
+    // one before; raw deflate streams that end on a sync flush can be joined
+    std::vector<uint8_t> filtered(total);
+    std::vector<std::vector<uint8_t>> parts(stripes);
+    std::vector<int> errors(stripes, Z_OK);
+    std::vector<uLong> checksums(stripes);
+    auto run = [&](auto &&job)
+    {
+        std::vector<std::thread> workers;
+        for (int i = 1; i < stripes; ++i)
+            workers.emplace_back(job, i);
+        job(0);
+        for (auto &thread : workers)
+            thread.join();
+    };
+    run([&](const int i)
+        { filterRows(pixels, width, firstRow(i), firstRow(i + 1), filtered.data() + pitch * firstRow(i), options.adaptive); });
+    run([&](const int i)
+        {
+            const size_t begin = pitch * firstRow(i);
+            const size_t end = pitch * firstRow(i + 1);
+            const size_t dictSize = std::min<size_t>(begin, WINDOW_SIZE);
+            errors[i] = deflateStripe(filtered.data() + begin, end - begin, filtered.data() + begin - dictSize, dictSize,
+                                      i == stripes - 1, options.level, parts[i]);
+            checksums[i] = adler32(adler32(0L, Z_NULL, 0), filtered.data() + begin, static_cast<uInt>(end - begin)); });
+    for (const int err : errors)
+    {
+        if (err != Z_OK)
+            return err;
+    }
+
+    // zlib wrapper: header, the stripes, adler32 of the whole
+    const int level = options.level == Z_DEFAULT_COMPRESSION ? 6 : options.level;
+    const int flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    const uint8_t cmf = 0x78;
+    uint8_t flg = static_cast<uint8_t>(flevel << 6);
+    flg += 31 - ((cmf * 256 + flg) % 31);
+    size_t size = 2 + 4;
+    for (const auto &part : parts)
+        size += part.size();
+    out.clear();
+    out.reserve(size);
+    out.push_back(cmf);
+    out.push_back(flg);
+    for (const auto &part : parts)
+        out.insert(out.end(), part.begin(), part.end());
+    uLong adler = checksums[0];
+    for (int i = 1; i < stripes; ++i)
+        adler = adler32_combine(adler, checksums[i], static_cast<z_off_t>(pitch * (firstRow(i + 1) - firstRow(i))));
+    putBigEndian(out, static_cast<uint32_t>(adler));
+    return Z_OK;
+}
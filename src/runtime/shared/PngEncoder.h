@@ -0,0 +1,37 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// How CFrame::toPng filters and compresses the image data.
+struct pngOptions_t
+{
+    bool adaptive = true; // per row, the filter that leaves the longest runs; otherwise None
+    int level = 6;        // zlib compression level
+    unsigned jobs = 0;    // stripes compressed in parallel, 0 for all cores
+};
+
+// Filter rows [first, last) of an 8-bit RGBA image. Each row of out starts
+// with its filter type byte and is width * 4 + 1 bytes long.
+void filterRows(const uint8_t *rgba, int width, int first, int last, uint8_t *out, bool adaptive);
+
+// The zlib stream of the filtered image, to be split into IDAT chunks.
+// Large images are cut into horizontal stripes that are filtered and
+// deflated on several threads, then joined on sync flush boundaries.
+int deflateImage(const uint32_t *rgba, int width, int height, std::vector<uint8_t> &out, const pngOptions_t &options);
@@ -0,0 +1,174 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstring>
+#include "Upscale.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define UPSCALE_SSE2
+#define UPSCALE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UPSCALE_SSE2
+#endif
+
+namespace UpscalePrivate
+{
+    // widen one row: each pixel is repeated factor times
+    void widenScalar(const uint32_t *src, uint32_t *dst, int width, const int factor)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const uint32_t c = src[x];
+            for (int i = 0; i < factor; ++i)
+                *dst++ = c;
+        }
+    }
+
+    void widen2(const uint32_t *src, uint32_t *dst, const int width)
+    {
+        int x = 0;
+#if defined(UPSCALE_AVX2)
+        for (; x + 8 <= width; x += 8)
+        {
+            // unpack works within 128-bit lanes: p0p0p1p1|p4p4p5p5 and p2p2p3p3|p6p6p7p7
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x));
+            const __m256i lo = _mm256_unpacklo_epi32(v, v);
+            const __m256i hi = _mm256_unpackhi_epi32(v, v);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 2), _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 2 + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+#endif
+#if defined(UPSCALE_SSE2)
+        for (; x + 4 <= width; x += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 2), _mm_unpacklo_epi32(v, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 2 + 4), _mm_unpackhi_epi32(v, v));
+        }
+#endif
+        widenScalar(src + x, dst + x * 2, width - x, 2);
+    }
+
+    void widen3(const uint32_t *src, uint32_t *dst, const int width)
+    {
+        int x = 0;
+#if defined(UPSCALE_SSE2)
+        for (; x + 4 <= width; x += 4)
+        {
+            // p0p0p0p1 p1p1p2p2 p2p3p3p3
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 3), _mm_shuffle_epi32(v, 0x40));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 3 + 4), _mm_shuffle_epi32(v, 0xa5));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 3 + 8), _mm_shuffle_epi32(v, 0xfe));
+        }
+#endif
+        widenScalar(src + x, dst + x * 3, width - x, 3);
+    }
+
+    void widen4(const uint32_t *src, uint32_t *dst, const int width)
+    {
+        int x = 0;
+#if defined(UPSCALE_AVX2)
+        for (; x + 8 <= width; x += 8)
+        {
+            // spread two pixels over each output vector
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x));
+            for (int i = 0; i < 4; ++i)
+            {
+                const __m256i index = _mm256_setr_epi32(i * 2, i * 2, i * 2, i * 2, i * 2 + 1, i * 2 + 1, i * 2 + 1, i * 2 + 1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x * 4 + i * 8), _mm256_permutevar8x32_epi32(v, index));
+            }
+        }
+#endif
+#if defined(UPSCALE_SSE2)
+        for (; x + 4 <= width; x += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4), _mm_shuffle_epi32(v, 0x00));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 + 4), _mm_shuffle_epi32(v, 0x55));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 + 8), _mm_shuffle_epi32(v, 0xaa));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x * 4 + 12), _mm_shuffle_epi32(v, 0xff));
+        }
+#endif
+        widenScalar(src + x, dst + x * 4, width - x, 4);
+    }
+};
+
+using namespace UpscalePrivate;
+
+/**
+ * @brief Nearest-neighbour upscale of a block of pixels
+ *
+ * Each source row is widened once, with SIMD where available, and the
+ * result is copied to the remaining factor - 1 destination rows.
+ *
+ * @param src first source pixel
+ * @param srcPitch pixels per source row
+ * @param dst first destination pixel
+ * @param dstPitch pixels per destination row
+ * @param width source width
+ * @param height source height
+ * @param factor scale, 1 or more
+ */
+void upscale(const uint32_t *src, const int srcPitch, uint32_t *dst, const int dstPitch, const int width, const int height, const int factor)
+{
+    if (width <= 0 || height <= 0 || factor < 1)
+        return;
+    const size_t rowSize = sizeof(uint32_t) * width * factor;
+    for (int y = 0; y < height; ++y)
+    {
+        const uint32_t *in = src + y * srcPitch;
+        uint32_t *out = dst + y * factor * dstPitch;
+        switch (factor)
+        {
+        case 1:
+            memcpy(out, in, rowSize);
+            break;
+        case 2:
+            widen2(in, out, width);
+            break;
+        case 3:
+            widen3(in, out, width);
+            break;
+        case 4:
+            widen4(in, out, width);
+            break;
+        default:
+            widenScalar(in, out, width, factor);
+        }
+        for (int i = 1; i < factor; ++i)
+            memcpy(out + i * dstPitch, out, rowSize);
+    }
+}
+
+/**
+ * @brief Name of the widening kernel selected at compile time
+ *
+ * @return const char*
+ */
+const char *upscaleKernel()
+{
+#if defined(UPSCALE_AVX2)
+    return "avx2";
+#elif defined(UPSCALE_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,24 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+#include <cstdint>
+
+// Nearest-neighbour upscaling by an integer factor. Pitches are in pixels.
+// The destination must hold width * factor by height * factor pixels.
+void upscale(const uint32_t *src, int srcPitch, uint32_t *dst, int dstPitch, int width, int height, int factor);
+const char *upscaleKernel();
@@ -0,0 +1,88 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "qrendertarget.h"
+#include "../Upscale.h"
+#include <QPainter>
+
+/**
+ * @brief Resize the framebuffer. The content is lost when the size changes.
+ *
+ * @param width
+ * @param height
+ * @param scale zoom factor applied when painting
+ * @return true if the buffer was reallocated
+ * @return false
+ */
+bool CRenderTarget::resize(const int width, const int height, const int scale)
+{
+    if (width == m_frame.width() && height == m_frame.height() && scale == m_scale && !m_image.isNull())
+        return false;
+
+    CFrame frame(width, height);
+    swap(m_frame, frame);
+    wrap(m_frame, m_image);
+    m_scale = scale;
+    CFrame scaled(scale > 1 ? width * scale : 0, scale > 1 ? height * scale : 0);
+    swap(m_scaled, scaled);
+    wrap(m_scaled, m_scaledImage);
+    return true;
+}
+
+void CRenderTarget::wrap(CFrame &frame, QImage &image)
+{
+    // the rows of a CFrame are packed: one uint32_t per pixel, no padding
+    image = QImage(reinterpret_cast<uchar *>(frame.getRGB().data()),
+                   frame.width(), frame.height(), frame.width() * sizeof(uint32_t), QImage::Format_RGBX8888);
+}
+
+/**
+ * @brief Paint part of the framebuffer at its zoomed position
+ *
+ * @param painter
+ * @param source area of the framebuffer
+ */
+void CRenderTarget::draw(QPainter &painter, const QRect &source)
+{
+    const QRect area = source.intersected(m_image.rect());
+    if (area.isEmpty())
+        return;
+    if (m_scale == 1)
+    {
+        painter.drawImage(area.topLeft(), m_image, area);
+        return;
+    }
+
+    // only the requested area is upscaled
+    const int pitch = m_frame.width();
+    const int scaledPitch = m_scaled.width();
+    upscale(m_frame.getRGB().data() + area.x() + area.y() * pitch, pitch,
+            m_scaled.getRGB().data() + (area.x() + area.y() * scaledPitch) * m_scale, scaledPitch,
+            area.width(), area.height(), m_scale);
+    const QRect target(area.x() * m_scale, area.y() * m_scale, area.width() * m_scale, area.height() * m_scale);
+    painter.drawImage(target.topLeft(), m_scaledImage, target);
+}
+
+/**
+ * @brief Paint the whole framebuffer at the origin
+ *
+ * @param painter
+ */
+void CRenderTarget::draw(QPainter &painter)
+{
+    draw(painter, m_image.rect());
+}
@@ -0,0 +1,61 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef __QT_RENDER_TARGET_H
+#define __QT_RENDER_TARGET_H
+
+#include <QImage>
+#include <QRect>
+#include "../Frame.h"
+
+class QPainter;
+
+/**
+ * @brief Framebuffer kept from one paint to the next, seen both as a
+ *        CFrame by the draw routines and as a QImage by the painter.
+ *
+ * The QImages wrap the pixels of the CFrames without copying them and
+ * are only rebuilt when the size changes. When zoomed, the frame is
+ * upscaled into a second, presentation buffer which is painted 1:1,
+ * so Qt never has to scale anything.
+ */
+class CRenderTarget
+{
+public:
+    CRenderTarget() = default;
+    CRenderTarget(const CRenderTarget &) = delete;
+    CRenderTarget &operator=(const CRenderTarget &) = delete;
+
+    bool resize(const int width, const int height, const int scale = 1);
+    void draw(QPainter &painter, const QRect &source);
+    void draw(QPainter &painter);
+    inline CFrame &frame() { return m_frame; }
+    inline const QImage &image() const { return m_image; }
+    inline int width() const { return m_frame.width(); }
+    inline int height() const { return m_frame.height(); }
+    inline int scale() const { return m_scale; }
+
+private:
+    static void wrap(CFrame &frame, QImage &image);
+    CFrame m_frame;
+    QImage m_image;
+    int m_scale = 1;
+    CFrame m_scaled; // presentation buffer, when zoomed
+    QImage m_scaledImage;
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <vector>
+#include "simrunner.h"
+#include "game.h"
+#include "gamestats.h"
+#include "states.h"
+#include "statedata.h"
+#include "joyaim.h"
+#include "events.h"
+#include "logger.h"
+#include "filemacros.h"
+#include "shared/IFile.h"
+
+CSimRunner::CSimRunner(CGame &game) : m_game(game)
+{
+}
+
+/**
+ * @brief Read a savegame written by CGameMixin::write().
+ *        The file is left positioned at the end of the save, which is
+ *        where a recorder stream (REC!) begins.
+ *
+ * @param sfile
+ * @param name savegame name
+ * @return true
+ * @return false
+ */
+bool CSimRunner::read(IFile &sfile, std::string &name)
+{
+    auto readfile = [&sfile](auto ptr, auto size)
+    {
+        return sfile.read(ptr, size) == 1;
+    };
+    if (!m_game.read(sfile))
+    {
+        return false;
+    }
+
+    int playerFrameOffset = 0;
+    int countdown = 0;
+    _R(&m_ticks, sizeof(m_ticks));
+    _R(&playerFrameOffset, sizeof(playerFrameOffset));
+    _R(&m_healthRef, sizeof(m_healthRef));
+    _R(&countdown, sizeof(countdown));
+
+    size_t ptr = 0;
+    sfile.seek(SAVENAME_PTR_OFFSET);
+    _R(&ptr, sizeof(uint32_t));
+    sfile.seek(ptr);
+    size_t size = 0;
+    _R(&size, sizeof(uint16_t));
+    std::vector<char> tmp(size + 1, '\0');
+    _R(tmp.data(), size);
+    name = tmp.data();
+
+    m_timer = TICK_RATE;
+    m_outcome = Running;
+    return true;
+}
+
+/**
+ * @brief Advance the simulation by one tick
+ *
+ * @param joyState JOY_AIMS entries, non-zero when pressed
+ * @return Outcome Running until the level is resolved
+ */
+CSimRunner::Outcome CSimRunner::step(const uint8_t *joyState)
+{
+    if (m_outcome != Running)
+        return m_outcome;
+
+    CGame &game = m_game;
+    ++m_ticks;
+
+    // events are only displayed by the front-ends
+    while (game.getEvent() != EVENT_NONE)
+        ;
+    manageTimer();
+    if (m_outcome != Running)
+        return m_outcome;
+
+    if ((game.tick(m_ticks, joyState, m_healthRef) & CGame::TICK_CLOSURE) &&
+        game.closusureTimer() == 0)
+        resolveClosure();
+    return m_outcome;
+}
+
+void CSimRunner::manageTimer()
+{
+    CGame &game = m_game;
+    if (m_timer)
+    {
+        --m_timer;
+        return;
+    }
+
+    game.incTimeTaken();
+    m_timer = TICK_RATE;
+    CStates &states = game.map().states();
+    const uint16_t timeout = states.getU(TIMEOUT);
+    if (timeout == 1)
+    {
+        game.killPlayer();
+        m_outcome = game.isGameOver() ? GameOver : TimedOut;
+    }
+    else if (timeout > 0)
+    {
+        states.setU(TIMEOUT, timeout - 1);
+    }
+}
+
+void CSimRunner::resolveClosure()
+{
+    CGame &game = m_game;
+    if (game.isPlayerDead())
+    {
+        game.killPlayer();
+        m_outcome = game.isGameOver() ? GameOver : Died;
+        return;
+    }
+
+    if (game.stats().get(S_CHUTE) != 0)
+    {
+        game.nextLevel();
+        m_outcome = Chute;
+        return;
+    }
+
+    const uint16_t exitKey = game.map().states().getU(POS_EXIT);
+    if (!game.isGameOver() && !game.goalCount() &&
+        (exitKey == 0 || game.player().pos() == CMap::toPos(exitKey)))
+    {
+        game.nextLevel();
+        m_outcome = Completed;
+    }
+}
+
+const char *CSimRunner::outcomeName(const Outcome outcome)
+{
+    switch (outcome)
+    {
+    case Running:
+        return "running";
+    case Completed:
+        return "completed";
+    case Chute:
+        return "chute";
+    case Died:
+        return "died";
+    case TimedOut:
+        return "timeout";
+    case GameOver:
+        return "gameover";
+    }
+    return "unknown";
+}
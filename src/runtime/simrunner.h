@@ -0,0 +1,75 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class CGame;
+class IFile;
+
+/**
+ * @brief Steps a game session without a front-end.
+ *
+ * Mirrors the gameplay part of CGameMixin::manageGamePlay() (timers,
+ * player, hurt stage, monsters, bosses and level closure) so that a session can be
+ * simulated as fast as the cpu allows. Rendering, camera, music and menus
+ * are left out; the run stops at the first level outcome.
+ */
+class CSimRunner
+{
+public:
+    enum Outcome : uint8_t
+    {
+        Running,
+        Completed,
+        Chute,
+        Died,
+        TimedOut,
+        GameOver,
+    };
+
+    enum : uint32_t
+    {
+        TICK_RATE = 24, // same as CGameMixin
+        JOY_AIMS = 4,
+    };
+
+    CSimRunner(CGame &game);
+    ~CSimRunner() {};
+
+    bool read(IFile &sfile, std::string &name);
+    Outcome step(const uint8_t *joyState);
+    uint32_t ticks() const { return m_ticks; }
+    Outcome outcome() const { return m_outcome; }
+    static const char *outcomeName(const Outcome outcome);
+
+private:
+    enum
+    {
+        SAVENAME_PTR_OFFSET = 8,
+    };
+
+    CGame &m_game;
+    uint32_t m_ticks = 0;
+    int m_timer = TICK_RATE;
+    int m_healthRef = 0; // health on the previous hurt check
+    Outcome m_outcome = Running;
+    void manageTimer();
+    void resolveClosure();
+};
@@ -0,0 +1,82 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Per-subsystem 64-bit hashes of a game session.
+ *        Used to detect replay desyncs.
+ */
+struct stateHash_t
+{
+    enum Part : uint8_t
+    {
+        TILES,
+        ATTRS,
+        ACTORS,
+        BOSSES,
+        STATS,
+        RNG,
+        MAX_PARTS
+    };
+    uint64_t parts[MAX_PARTS];
+
+    static const char *partName(const int part)
+    {
+        constexpr const char *names[] = {"tiles", "attrs", "actors", "bosses", "stats", "rng"};
+        return part >= 0 && part < MAX_PARTS ? names[part] : "unknown";
+    }
+
+    // first subsystem that differs; MAX_PARTS if identical
+    int diff(const stateHash_t &other) const
+    {
+        for (int i = 0; i < MAX_PARTS; ++i)
+        {
+            if (parts[i] != other.parts[i])
+                return i;
+        }
+        return MAX_PARTS;
+    }
+};
+
+namespace StateHash
+{
+    // splitmix64 finalizer
+    inline uint64_t mix(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // contribution of one map cell; empty cells contribute nothing so
+    // that the xor of all cells can be maintained on each write
+    inline uint64_t cell(const int x, const int y, const uint8_t v)
+    {
+        return v ? mix((static_cast<uint64_t>(y & 0xffff) << 24) |
+                       (static_cast<uint64_t>(x & 0xffff) << 8) | v)
+                 : 0;
+    }
+
+    inline uint64_t combine(const uint64_t h, const uint64_t v)
+    {
+        return mix(h ^ v);
+    }
+};
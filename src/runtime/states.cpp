@@ -22,6 +22,7 @@
 
 void CStates::setU(const uint16_t k, const uint16_t v)
 {
+    ++m_changes;
     if (v)
         m_stateU[k] = v;
     else
@@ -30,6 +31,7 @@ void CStates::setU(const uint16_t k, const uint16_t v)
 
 void CStates::setS(const uint16_t k, const std::string &v)
 {
+    ++m_changes;
     if (v.size())
         m_stateS[k] = v;
     else
@@ -84,6 +86,7 @@ bool CStates::readCommon(ReadFunc readfile)
     if (!readfile(&count, COUNT_BYTES))
         return false;
 
+    ++m_changes;
     m_stateU.clear();
     for (size_t i = 0; i < count; ++i)
     {
@@ -207,6 +210,7 @@ bool CStates::writeCommon(WriteFunc writefile) const
 
 void CStates::clear()
 {
+    ++m_changes;
     m_stateS.clear();
     m_stateU.clear();
 }
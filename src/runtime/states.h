@@ -57,10 +57,13 @@ public:
     std::vector<StateValuePair> getValues() const;
     const std::unordered_map<uint16_t, std::string> &rawS() { return m_stateS; }
     const std::unordered_map<uint16_t, uint16_t> &rawU() { return m_stateU; }
+    // bumped by every change, so the owner can tell its cached values are stale
+    inline uint32_t changes() const { return m_changes; }
 
 private:
     std::unordered_map<uint16_t, std::string> m_stateS;
     std::unordered_map<uint16_t, uint16_t> m_stateU;
+    uint32_t m_changes = 0;
     enum
     {
         MAX_STRING = 1024,
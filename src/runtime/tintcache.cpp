@@ -0,0 +1,62 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <functional>
+#include "tintcache.h"
+#include "shared/Frame.h"
+
+CTintCache::~CTintCache()
+{
+}
+
+size_t CTintCache::keyHash_t::operator()(const key_t &key) const
+{
+    const size_t h = std::hash<const void *>()(key.frame);
+    return h ^ (std::hash<const void *>()(key.colorMap) * 31) ^ (key.effect << 8 | key.shift);
+}
+
+/**
+ * @brief Get the recoloured variant of a frame, making it if needed
+ *
+ * @param frame source frame
+ * @param op effect, fade and colour map; the transparency is ignored
+ * @return CFrame*
+ */
+CFrame *CTintCache::get(CFrame *frame, const blitOp_t &op)
+{
+    const key_t key{frame, op.colorMap, op.effect, op.shift};
+    auto it = m_variants.find(key);
+    if (it != m_variants.end())
+        return it->second.get();
+
+    auto variant = std::make_unique<CFrame>(frame->width(), frame->height());
+    blitOp_t bake = op;
+    bake.transparency = BLIT_SKIP_CLEAR;
+    blit(variant->getRGB().data(), variant->width(), frame->getRGB().data(), frame->width(), frame->width(), frame->height(), bake);
+    CFrame *ptr = variant.get();
+    m_variants.emplace(key, std::move(variant));
+    return ptr;
+}
+
+/**
+ * @brief Drop every variant
+ *
+ */
+void CTintCache::clear()
+{
+    m_variants.clear();
+}
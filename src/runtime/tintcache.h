@@ -0,0 +1,64 @@
+/*
+    cs3-runtime-sdl
+    Copyright (C) 2025 Francois Blanchette
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include "blitter.h"
+
+class CFrame;
+
+/**
+ * @brief Recoloured copies of frames, made on first use and kept.
+ *
+ * A variant is identified by its source frame, its effect, its fade
+ * and its colour map. Pixels skipped by the recolouring are left clear,
+ * so a variant is drawn as a plain transparent blit. The owner clears
+ * the cache when the frames or the colour maps are reloaded.
+ */
+class CTintCache
+{
+public:
+    CTintCache() = default;
+    ~CTintCache();
+
+    CFrame *get(CFrame *frame, const blitOp_t &op);
+    void clear();
+    size_t size() const { return m_variants.size(); }
+
+private:
+    struct key_t
+    {
+        const CFrame *frame;
+        const void *colorMap;
+        uint8_t effect;
+        uint8_t shift;
+        bool operator==(const key_t &other) const
+        {
+            return frame == other.frame && colorMap == other.colorMap && effect == other.effect && shift == other.shift;
+        }
+    };
+
+    struct keyHash_t
+    {
+        size_t operator()(const key_t &key) const;
+    };
+
+    std::unordered_map<key_t, std::unique_ptr<CFrame>, keyHash_t> m_variants;
+};
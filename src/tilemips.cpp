@@ -0,0 +1,80 @@
+#include "tilemips.h"
+#include "runtime/shared/FrameSet.h"
+#include "runtime/shared/Frame.h"
+
+namespace TileMipsPrivate
+{
+    constexpr uint32_t ALPHA = 0xff000000;
+
+    /**
+     * @brief Halve a square block of pixels, averaging each channel
+     *
+     * @param src size x size pixels
+     * @param dest (size / 2) x (size / 2) pixels
+     * @param size
+     */
+    void halve(const uint32_t *src, uint32_t *dest, const int size)
+    {
+        const int half = size / 2;
+        for (int y = 0; y < half; ++y) {
+            for (int x = 0; x < half; ++x) {
+                const uint32_t *p = src + 2 * x + 2 * y * size;
+                const uint32_t quad[] = {p[0], p[1], p[size], p[size + 1]};
+                uint32_t rgb = 0;
+                for (int shift = 0; shift < 24; shift += 8) {
+                    uint32_t sum = 0;
+                    for (const uint32_t c : quad) {
+                        sum += (c >> shift) & 0xff;
+                    }
+                    rgb |= ((sum + 2) / 4) << shift;
+                }
+                dest[x + y * half] = rgb | ALPHA;
+            }
+        }
+    }
+};
+
+using namespace TileMipsPrivate;
+
+/**
+ * @brief Make the levels of every frame
+ *
+ * @param frames 16x16 frames
+ */
+void CTileMips::build(CFrameSet &frames)
+{
+    m_count = static_cast<int>(frames.getSize());
+    m_pixels.assign(size_t(m_count) * MIP_PIXELS, ALPHA);
+    for (int i = 0; i < m_count; ++i) {
+        CFrame *frame = frames[i];
+        if (!frame || frame->width() != TILE_SIZE || frame->height() != TILE_SIZE) {
+            continue;
+        }
+        uint32_t *mip = &m_pixels[size_t(i) * MIP_PIXELS];
+        halve(frame->getRGB().data(), mip, TILE_SIZE);
+        for (int size = 8; size > 1; size /= 2) {
+            uint32_t *next = mip + size * size;
+            halve(mip, next, size);
+            mip = next;
+        }
+    }
+}
+
+/**
+ * @brief Pixels of a frame at a given size
+ *
+ * @param frame
+ * @param size 8, 4, 2 or 1
+ * @return const uint32_t* size x size pixels, nullptr if the frame doesn't exist
+ */
+const uint32_t *CTileMips::level(const int frame, const int size) const
+{
+    if (frame < 0 || frame >= m_count) {
+        return nullptr;
+    }
+    int offset = 0;
+    for (int s = 8; s > size && s > 1; s /= 2) {
+        offset += s * s;
+    }
+    return &m_pixels[size_t(frame) * MIP_PIXELS + offset];
+}
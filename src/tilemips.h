@@ -0,0 +1,33 @@
+#ifndef TILEMIPS_H
+#define TILEMIPS_H
+
+#include <cstdint>
+#include <vector>
+
+class CFrameSet;
+
+/**
+ * @brief Reduced copies of each frame of a set: 8x8, 4x4, 2x2 and 1x1,
+ *        each level the average of 2x2 pixels of the one above.
+ *
+ * Used to draw the map zoomed out without scaling the 16x16 tiles
+ * every time; the levels of a frame are stored next to each other.
+ */
+class CTileMips
+{
+public:
+    void build(CFrameSet &frames);
+    const uint32_t *level(const int frame, const int size) const;
+    int count() const { return m_count; }
+
+    enum : int {
+        TILE_SIZE = 16,
+        MIP_PIXELS = 8 * 8 + 4 * 4 + 2 * 2 + 1, // per frame
+    };
+
+private:
+    std::vector<uint32_t> m_pixels;
+    int m_count = 0;
+};
+
+#endif // TILEMIPS_H